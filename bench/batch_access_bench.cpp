@@ -0,0 +1,239 @@
+// Raed Abuzaid
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "MemoryManager.hpp"
+
+/**
+ * Batched memory access against one accessAddress call per address.
+ * Usage: batch_access_bench [configs]
+ * First replays random call sequences under random configurations (default 3000) through both
+ * paths and fails if frames, replacement, TLB, prefetch or copy-on-write counters differ at any
+ * point, then times both paths on a long run of accesses.
+ */
+
+namespace
+{
+    constexpr int POLICIES{6};
+    constexpr unsigned long long TIMED_ACCESSES{20000000};
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Config
+    {
+        ReplacementPolicyType policy;
+        unsigned long long frames;
+        unsigned int pageSize;
+        unsigned int tlbSets;
+        unsigned int prefetchDepth;
+        unsigned int prefetchPressureDepth;
+        bool copyOnWriteFork;
+    };
+
+    struct Call
+    {
+        int pid;
+        bool write;
+        std::vector<unsigned long long> addresses;
+    };
+
+    /**
+     * @param config : configuration
+     * @return : memory manager set up for it
+     */
+    MemoryManager build(const Config &config)
+    {
+        MemoryManager memory(config.frames * config.pageSize, config.pageSize, config.policy, config.tlbSets, 2);
+        if (config.prefetchDepth != 0)
+        {
+            memory.enablePrefetching(config.prefetchDepth, config.prefetchPressureDepth);
+        }
+        if (config.copyOnWriteFork)
+        {
+            memory.enableCopyOnWriteFork();
+        }
+        return memory;
+    }
+
+    /**
+     * @param single : memory driven one address at a time
+     * @param batched : memory driven through accessAddresses
+     * @return : true if both are in the same state
+     */
+    bool same(MemoryManager &single, MemoryManager &batched)
+    {
+        MemoryUsage a = single.getMemoryUsage();
+        MemoryUsage b = batched.getMemoryUsage();
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].PID != b[i].PID || a[i].pageNumber != b[i].pageNumber || a[i].frameNumber != b[i].frameNumber)
+            {
+                return false;
+            }
+        }
+
+        ReplacementStats ra = single.getReplacementStats();
+        ReplacementStats rb = batched.getReplacementStats();
+        TLBStats ta = single.getTLBStats();
+        TLBStats tb = batched.getTLBStats();
+        PrefetchStats pa = single.getPrefetchStats();
+        PrefetchStats pb = batched.getPrefetchStats();
+        CopyOnWriteStats ca = single.getCopyOnWriteStats();
+        CopyOnWriteStats cb = batched.getCopyOnWriteStats();
+
+        return ra.hits == rb.hits && ra.misses == rb.misses && ra.evictions == rb.evictions &&
+               ta.hits == tb.hits && ta.misses == tb.misses && ta.invalidations == tb.invalidations &&
+               pa.issued == pb.issued && pa.useful == pb.useful && pa.wasted == pb.wasted &&
+               pa.throttled == pb.throttled && ca.sharedPages == cb.sharedPages && ca.copies == cb.copies;
+    }
+
+    /**
+     * Applies calls through both paths, comparing after each one
+     * @param config : configuration
+     * @param calls : calls in order, pid 2 is forked from pid 1 before the first of its calls
+     * @return : index of the first call after which the paths differ, calls.size() if none
+     */
+    std::size_t compare(const Config &config, const std::vector<Call> &calls)
+    {
+        MemoryManager single = build(config);
+        MemoryManager batched = build(config);
+        bool forked = false;
+
+        for (std::size_t c = 0; c < calls.size(); c++)
+        {
+            const Call &call = calls[c];
+            if (call.pid == 2 && !forked)
+            {
+                single.forkMemory(1, 2);
+                batched.forkMemory(1, 2);
+                forked = true;
+            }
+
+            for (unsigned long long address : call.addresses)
+            {
+                single.accessAddress(call.pid, address, call.write);
+            }
+            batched.accessAddresses(call.pid, call.addresses.data(), call.addresses.size(), call.write);
+
+            if (!same(single, batched))
+            {
+                return c;
+            }
+        }
+
+        return calls.size();
+    }
+
+    /**
+     * @param start : start time
+     * @return : accesses per second since start
+     */
+    double throughput(Clock::time_point start)
+    {
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        return TIMED_ACCESSES / elapsed.count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long long configs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3000ULL;
+
+    // ARC with 3 frames and a one page window, page numbers [3 2 3] then [2 1 1]
+    {
+        Config config{ReplacementPolicyType::ARC, 3, 16, 16, 1, 1, false};
+        std::vector<Call> calls{{1, false, {48, 32, 48}}, {1, false, {32, 16, 16}}};
+        if (compare(config, calls) != calls.size())
+        {
+            std::fprintf(stderr, "batched and single accesses differ on the ARC prefetch case\n");
+            return 1;
+        }
+    }
+
+    unsigned long long mismatches = 0;
+    for (unsigned long long seed = 0; seed < configs; seed++)
+    {
+        std::mt19937_64 rng(seed);
+
+        Config config;
+        config.policy = static_cast<ReplacementPolicyType>(rng() % POLICIES);
+        config.frames = 1 + rng() % 12;
+        config.pageSize = rng() % 2 ? 16 : 24;
+        config.tlbSets = rng() % 2 ? 4 : 0;
+        config.prefetchDepth = rng() % 4;
+        config.prefetchPressureDepth = rng() % 3;
+        config.copyOnWriteFork = rng() % 2;
+
+        // short runs over a few pages, with sequential stretches so streams form
+        std::vector<Call> calls(20);
+        unsigned long long next = 0;
+        for (Call &call : calls)
+        {
+            call.pid = 1 + rng() % 2;
+            call.write = rng() % 4 == 0;
+            for (int run = 1 + rng() % 4; run > 0; run--)
+            {
+                unsigned long long page = rng() % 3 ? next++ % 24 : rng() % 24;
+                for (int repeat = 1 + rng() % 3; repeat > 0; repeat--)
+                {
+                    call.addresses.push_back(page * config.pageSize + rng() % config.pageSize);
+                }
+            }
+        }
+
+        std::size_t differs = compare(config, calls);
+        if (differs != calls.size())
+        {
+            std::fprintf(stderr, "config %llu: policy %d, %llu frames, page size %u, depth %u/%u: differs after call %zu\n",
+                         seed, static_cast<int>(config.policy), config.frames, config.pageSize, config.prefetchDepth,
+                         config.prefetchPressureDepth, differs);
+            mismatches++;
+        }
+    }
+
+    if (mismatches != 0)
+    {
+        std::fprintf(stderr, "%llu of %llu configurations differ between batched and single accesses\n", mismatches,
+                     configs);
+        return 1;
+    }
+    std::printf("%llu configurations, batched and single accesses agree\n", configs);
+
+    // throughput on runs of 16 accesses per page over a working set larger than RAM
+    std::vector<unsigned long long> addresses(TIMED_ACCESSES);
+    for (unsigned long long i = 0; i < TIMED_ACCESSES; i++)
+    {
+        addresses[i] = (i / 16) % 100000 * 4096 + i % 16 * 8;
+    }
+
+    std::printf("%16s %16s %8s\n", "single/s", "batched/s", "speedup");
+    double singleRate = 0;
+    {
+        MemoryManager memory(65536ULL * 4096, 4096, ReplacementPolicyType::LRU, 16, 4);
+        Clock::time_point start = Clock::now();
+        for (unsigned long long address : addresses)
+        {
+            memory.accessAddress(1, address);
+        }
+        singleRate = throughput(start);
+    }
+
+    double batchedRate = 0;
+    {
+        MemoryManager memory(65536ULL * 4096, 4096, ReplacementPolicyType::LRU, 16, 4);
+        Clock::time_point start = Clock::now();
+        memory.accessAddresses(1, addresses.data(), addresses.size());
+        batchedRate = throughput(start);
+    }
+
+    std::printf("%16.0f %16.0f %7.2fx\n", singleRate, batchedRate, batchedRate / singleRate);
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Raed Abuzaid
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "PageTable.hpp"
+
+/**
+ * Page table lookup throughput, PageTable against the std::map it replaced.
+ * Usage: page_table_bench [maxResidentPages]
+ * Resident page counts run from 10^4 up to maxResidentPages (default 10^7) in powers of ten.
+ */
+
+namespace
+{
+    constexpr int PROCESSES{64};
+    constexpr unsigned long long LOOKUPS{2000000};
+
+    using Clock = std::chrono::steady_clock;
+    using MapTable = std::map<std::pair<int, unsigned long long>, unsigned long long>;
+
+    struct Key
+    {
+        int PID;
+        unsigned long long pageNumber;
+    };
+
+    /**
+     * @param start : start time
+     * @return : lookups per second since start
+     */
+    double throughput(Clock::time_point start)
+    {
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        return LOOKUPS / elapsed.count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long long maxPages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000ULL;
+
+    std::printf("%12s %16s %16s %8s\n", "pages", "map lookups/s", "table lookups/s", "speedup");
+
+    for (unsigned long long pages = 10000; pages <= maxPages; pages *= 10)
+    {
+        // resident pages spread over a few processes, each with a sparse address space
+        std::mt19937_64 rng(pages);
+        std::vector<Key> keys(pages);
+        for (unsigned long long i = 0; i < pages; i++)
+        {
+            keys[i].PID = static_cast<int>(i % PROCESSES) + 1;
+            keys[i].pageNumber = (i / PROCESSES) * 3 + rng() % 3;
+        }
+
+        std::vector<unsigned long long> probes(LOOKUPS);
+        for (unsigned long long &probe : probes)
+        {
+            probe = rng() % pages;
+        }
+
+        unsigned long long checksum = 0;
+        double mapRate = 0;
+        {
+            MapTable map;
+            for (unsigned long long i = 0; i < pages; i++)
+            {
+                map[std::make_pair(keys[i].PID, keys[i].pageNumber)] = i;
+            }
+
+            Clock::time_point start = Clock::now();
+            for (unsigned long long probe : probes)
+            {
+                checksum += map.find(std::make_pair(keys[probe].PID, keys[probe].pageNumber))->second;
+            }
+            mapRate = throughput(start);
+        }
+
+        double tableRate = 0;
+        {
+            PageTable table(pages);
+            for (unsigned long long i = 0; i < pages; i++)
+            {
+                table.insert(keys[i].PID, keys[i].pageNumber, i);
+            }
+
+            Clock::time_point start = Clock::now();
+            for (unsigned long long probe : probes)
+            {
+                checksum -= *table.find(keys[probe].PID, keys[probe].pageNumber);
+            }
+            tableRate = throughput(start);
+        }
+
+        if (checksum != 0)
+        {
+            std::fprintf(stderr, "lookup mismatch between map and page table\n");
+            return 1;
+        }
+
+        std::printf("%12llu %16.0f %16.0f %7.2fx\n", pages, mapRate, tableRate, tableRate / mapRate);
+    }
+
+    return 0;
+}
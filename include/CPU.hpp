@@ -4,55 +4,124 @@
 #define CPU_HPP_
 
 #include <deque>
-#include <algorithm>
+#include <memory>
+#include <vector>
+#include "ReadyQueue.hpp" // for NO_PROCESS
+#include "Scheduler.hpp"
 
-constexpr int NO_PROCESS{0};
+struct CoreStats
+{
+    unsigned long long migrations{0}; // processes started here after last running on another core
+    unsigned long long steals{0};     // processes this core took from the tail of another core's queue
+    unsigned long long dispatches{0}; // processes started here, a process kept running after its quantum is not counted again
+};
 
+/**
+ * One or more cores, each running a process and owning a ready queue ordered by the scheduler.
+ * New and woken processes go to the least loaded core, preferring the core they last ran on.
+ * A core that runs out of work steals from the busiest other queue.
+ * With a single core and the round robin scheduler this is plain round robin over one FIFO queue.
+ */
 class CPU
 {
 private:
-    int runningProcess_;
-    std::deque<int> readyQueue_;
+    std::vector<int> runningProcesses_; // per core
+    std::unique_ptr<Scheduler> scheduler_; // holds the ready queue of every core
+    std::vector<int> lastCore_;         // per pid, core it last ran on, -1 if it never ran
+    std::vector<CoreStats> stats_;      // per core
+
+    /**
+     * @param core : core index
+     * @return : running process plus queued processes of the core
+     */
+    std::size_t load(int core) const;
+
+    /**
+     * Puts a process on a core and records a migration if it last ran elsewhere
+     * @param pid : process pid
+     * @param core : core index
+     */
+    void run(int pid, int core);
 
 public:
-    // Default constructor
-    CPU();
+    /**
+     * @param cores : number of cores
+     * @param scheduler : policy ordering the ready queues
+     */
+    CPU(int cores = 1, SchedulerType scheduler = SchedulerType::ROUND_ROBIN);
+
+    /**
+     * Starts the next process the scheduler picks for a core, stealing one from the busiest other core if it has none
+     * @param core : core index
+     */
+    void startProcess(int core = 0);
 
     /**
-     * Starts a process
+     * Starts a process on every idle core that can find one
      */
-    void startProcess();
+    void startIdleCores();
 
     /**
-     * @param: process pid
-     * Adds process to CPU Ready queue
+     * Adds process to the ready queue of the least loaded core, taking the core right away if the scheduler prefers it
+     * to the running process
+     * @param pid : process pid
+     * @param reason : why it became ready
      */
-    void addProcess(int pid);
+    void addProcess(int pid, ReadyReason reason);
 
     /**
-     * Sets running process to no process
+     * Sets running process of a core to no process
+     * @param core : core index
      */
-    void removeRunningProcess();
+    void removeRunningProcess(int core = 0);
 
     /**
-     * Handles Timer interrupt from OS by pushing running process to back of ready queue
+     * Handles Timer interrupt from OS by handing the running process back to the scheduler, unless nothing else is ready
+     * @param core : core index
      */
-    void handleTimerInterrupt();
+    void handleTimerInterrupt(int core = 0);
 
     /**
-     * @return: currently running process
+     * @param core : core index
+     * @return: currently running process of the core
      */
-    int getRunningProcess();
+    int getRunningProcess(int core = 0);
 
     /**
-     * @return: the ready queue
+     * @param core : core index
+     * @return: the ready queue of the core
      */
-    std::deque<int> getReadyQueue();
+    std::deque<int> getReadyQueue(int core = 0);
 
-    /** // for std::remove, std::remove_if
-     * Removed process from cpu ready queue
+    /**
+     * Takes a process off the CPU entirely, whether it is queued or running on some core
+     * @param pid : process pid
+     */
+    void removeProcess(int pid);
+
+    /**
+     * Takes a set of processes off the CPU entirely, checking each core once
+     * @param pids : the processes
+     * @param terminated : true at the index of every pid in pids
+     */
+    void removeProcesses(const std::vector<int> &pids, const std::vector<bool> &terminated);
+
+    /**
+     * @param pid : process pid
+     * @param priority : 0 is the highest, PRIORITY_LEVELS - 1 the lowest
+     */
+    void setPriority(int pid, int priority);
+
+    /**
+     * @return : number of cores
+     */
+    int getNumberOfCores() const;
+
+    /**
+     * @param core : core index
+     * @return : migration and steal counters of the core
      */
-    void removeFromReadyQueue(int pid);
+    const CoreStats &getCoreStats(int core) const;
 };
 
-#endif // CPU_HPP_
\ No newline at end of file
+#endif // CPU_HPP_
@@ -4,71 +4,243 @@
 #define DISK_MANAGER_HPP_
 
 #include <deque>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include "DiskScheduler.hpp"
+#include "FileCache.hpp"
 
-struct FileReadRequest
+/**
+ * Geometry and timing shared by every disk, times are in arbitrary units
+ */
+struct DiskModel
 {
-    int PID{0};
-    std::string fileName{""};
+    unsigned long long blocks{1 << 16};  // request positions run from 0 to blocks - 1
+    unsigned long long seekTime{1};      // time for the head to pass one block
+    unsigned long long accessTime{4096}; // rotation and transfer time paid by every request
+    unsigned long long rotationTime{0};  // random extra delay of every request, uniform below this, 0 for none
+    unsigned int queueDepth{1};          // requests served at once, each in its own slot
+};
 
-    // Param Constructor
-    FileReadRequest(int pid = 0, std::string name = "") : PID{pid}, fileName{name} {}
+struct DiskStats
+{
+    unsigned long long served{0};       // disk operations completed, coalesced requests share one
+    unsigned long long started{0};      // disk operations the head moved to, cancelled ones included
+    unsigned long long headMovement{0}; // blocks travelled by the head
+    unsigned long long totalLatency{0}; // time from request to completion, summed, average = totalLatency / served
+    unsigned long long cancelled{0};    // requests dropped because their process terminated
+    unsigned long long coalesced{0};    // requests attached to a read of the same file already on the disk
 };
 
-struct Disk
+constexpr unsigned long long NO_READ{~0ULL};
+
+/**
+ * A request that is waiting for or being served by a disk.
+ * Requests sharing one disk operation form a ring in arrival order; the first one leads it and
+ * is the one the disk queue knows about. Without coalescing every ring holds a single request.
+ */
+struct OutstandingRead
+{
+    int PID;
+    int diskNumber;
+    FileId file;
+    DiskScheduler::Handle handle;     // position in the disk queue while it waits, leader only
+    bool serving;                     // the disk is serving it, handle is no longer valid, leader only
+    int slot;                         // slot serving it, leader only
+    bool leader;                      // first request of its operation
+    unsigned long long prevWaiter;    // ring of requests sharing the operation
+    unsigned long long nextWaiter;
+    unsigned long long prevOfProcess; // NO_READ at the head of the process chain
+    unsigned long long nextOfProcess; // NO_READ at the tail of the process chain
+};
+
+constexpr int NO_SLOT{-1};
+
+/**
+ * One request a disk is serving
+ */
+struct DiskSlot
 {
-    std::deque<FileReadRequest> diskQueue_;
-    FileReadRequest currentlyServing;
+    DiskRequest serving;                 // PID 0 while the slot is free
+    unsigned long long read{NO_READ};    // outstanding read leading the request
+    unsigned long long arrival{0};       // when the request was made
+    unsigned long long finishTime{0};    // when the request finishes
+    unsigned long long operation{0};     // value of DiskStats::started when it was dispatched
+    int older{NO_SLOT};                  // slots in flight, in dispatch order
+    int newer{NO_SLOT};
+};
 
-    // Default constructor
-    Disk() : diskQueue_(), currentlyServing(FileReadRequest(0, "")) {}
+/**
+ * A disk serving up to queueDepth requests at once. Free slots are kept on a stack and busy ones on a
+ * list in dispatch order, so dispatching a request and retiring any slot, or the oldest one, are O(1).
+ */
+struct Disk
+{
+    std::unique_ptr<DiskScheduler> diskQueue_;
+    std::vector<DiskSlot> slots;
+    std::vector<int> freeSlots;
+    int oldest{NO_SLOT};                     // busy slot dispatched first
+    int newest{NO_SLOT};
+    std::unordered_map<FileId, unsigned long long> files; // blocks of placed files
+    unsigned long long head{0};              // block under the head
+    unsigned long long time{0};              // when the last request started or finished, whichever was later
+    std::vector<unsigned long long> pendingReads; // file id -> leader of its operation or NO_READ, when coalescing
+    DiskModel model;
+    unsigned long long random;               // state of the rotational delay generator
+    DiskStats stats;
 
     // Param constructor
-    Disk(FileReadRequest currentlyServing)
-        : diskQueue_(), currentlyServing(currentlyServing) {}
+    Disk(std::unique_ptr<DiskScheduler> scheduler, DiskModel diskModel, unsigned long long seed)
+        : diskQueue_(std::move(scheduler)), slots(diskModel.queueDepth == 0 ? 1 : diskModel.queueDepth),
+          model(diskModel), random(seed)
+    {
+        for (int slot = static_cast<int>(slots.size()) - 1; slot >= 0; slot--)
+        {
+            freeSlots.push_back(slot); // slot 0 is used first
+        }
+    }
 };
 
 class DiskManager
 {
 private:
-    std::unordered_map<int, Disk> disks_;
+    std::vector<Disk> disks_;
     int numberOfDisks_;
+    unsigned long long clock_; // virtual time, an idle disk starts a new request no earlier than this
+    FileNameTable fileNames_;
+    std::unique_ptr<FileCache> fileCache_; // only set when file caching is on
+    bool coalescing_;                      // reads of a file already on a disk join that read
+    std::vector<int> completed_;           // processes woken by the last completed job
+    std::vector<int> freedDisks_;          // disks that gave up a slot during deleteRequests, to refill
+    std::vector<OutstandingRead> reads_; // every request not completed yet, by id
+    std::vector<unsigned long long> freeReads_;
+    std::vector<unsigned long long> processReads_; // pid -> first read of its chain, NO_READ if none
+
+    /**
+     * Records a new outstanding read at the front of its process chain, leading an operation of its own
+     * @param pid : process pid
+     * @param diskNumber : disk number
+     * @param file : interned file name
+     * @return : read id
+     */
+    unsigned long long trackRead(int pid, int diskNumber, FileId file);
+
+    /**
+     * Forgets an outstanding read
+     * @param read : read id
+     */
+    void untrackRead(unsigned long long read);
+
+    /**
+     * Moves the head to the next waiting requests of a disk and starts serving them, until every slot is busy
+     * or nothing is waiting
+     * @param disk : the disk
+     */
+    void serveNext(Disk &disk);
+
+    /**
+     * Frees a busy slot
+     * @param disk : the disk
+     * @param slot : slot index
+     */
+    void releaseSlot(Disk &disk, int slot);
+
+    /**
+     * Joins a read to the operation another read leads, behind every request already in it
+     * @param leader : read leading the operation
+     * @param read : read to attach
+     */
+    void attachRead(unsigned long long leader, unsigned long long read);
+
+    /**
+     * Takes a read out of its operation. The operation goes on for the others if it has any,
+     * otherwise it leaves the disk queue, or frees its slot if it was being served and
+     * records the disk in freedDisks_.
+     * @param read : read id
+     */
+    void detachRead(unsigned long long read);
+
+    /**
+     * Stops a read from being the one later reads of its file join, if it is
+     * @param disk : disk of the read
+     * @param file : file the read is for
+     * @param read : read id
+     */
+    void clearPending(Disk &disk, FileId file, unsigned long long read);
 
 public:
-    // Parametized constructor
-    DiskManager(int numberOfDisks);
+    /**
+     * @param numberOfDisks : number of disks
+     * @param scheduler : head scheduling policy of every disk
+     * @param models : geometry and timing, disk i uses models[i], or the default model if there are fewer
+     * @param seed : seed of the rotational delays
+     */
+    DiskManager(int numberOfDisks, DiskSchedulerType scheduler = DiskSchedulerType::FCFS,
+                const std::vector<DiskModel> &models = std::vector<DiskModel>(), unsigned long long seed = 0);
 
     /**
-     * Creates a read request with given parameters sends to disk
-     * @param : process pid
-     * @param : requested disk number
-     * @param : File name
+     * Creates a read request with given parameters sends to disk, unless the file cache has the file
+     * @param pid : process pid
+     * @param diskNumber : requested disk number
+     * @param fileName : File name
+     * @return : true if the read was served from the file cache and nothing was queued
      */
-    void readRequest(int pid, int diskNumber, std::string fileName);
+    bool readRequest(int pid, int diskNumber, const std::string &fileName);
 
     /**
-     * Disk Completes one process
+     * Disk Completes the oldest operation it is serving
      * @param diskNumber : Disk Number
-     * @return : process served
+     * @return : processes served, in the order they asked, empty if the disk was idle
      */
-    int completeJob(int diskNumber);
+    const std::vector<int> &completeJob(int diskNumber);
 
     /**
-     * Deletes requests of process from all disk without completing
-     * @param pid : process pid
+     * Disk Completes the operation in one slot
+     * @param diskNumber : Disk Number
+     * @param slot : slot below the queue depth of the disk
+     * @return : processes served, in the order they asked, empty if the slot was free
      */
-    void deleteRequests(int pid);
+    const std::vector<int> &completeJob(int diskNumber, int slot);
+
+    /**
+     * Deletes requests of a set of processes from all disk without completing, including ones a disk is serving.
+     * Only the requests of those processes are visited, and the disks that lost a served request refill their
+     * slots once all of them are gone.
+     * @param pids : the processes
+     */
+    void deleteRequests(const std::vector<int> &pids);
 
     /**
      * @param diskNumber : disk number
-     * @return : request at front of disk, else empy request
+     * @return : oldest request the disk is serving, else empy request
      */
     FileReadRequest getDiskStatus(int diskNumber);
 
     /**
      * @param diskNumber : disk number
-     * @return : return queue of requested disk number
+     * @param slot : slot below the queue depth of the disk
+     * @return : request served in the slot, else empty request
+     */
+    FileReadRequest getDiskStatus(int diskNumber, int slot);
+
+    /**
+     * @param diskNumber : disk number
+     * @param slot : slot below the queue depth of the disk
+     * @return : the slot
+     */
+    const DiskSlot &getSlot(int diskNumber, int slot) const;
+
+    /**
+     * @param diskNumber : disk number
+     * @return : number of slots of the disk
+     */
+    int getQueueDepth(int diskNumber) const;
+
+    /**
+     * @param diskNumber : disk number
+     * @return : return queue of requested disk number, in the order it would be served.
+     *           Requests attached to those being served come first, each queued request is followed by those attached to it.
      */
     std::deque<FileReadRequest> getDiskQueue(int diskNumber);
 
@@ -76,6 +248,68 @@ public:
      * @return : number of disks
      */
     int getNumberOfDisks();
+
+    /**
+     * Changes the head scheduling policy of a disk, waiting requests keep their arrival order
+     * @param diskNumber : disk number
+     * @param scheduler : new policy
+     */
+    void setScheduler(int diskNumber, DiskSchedulerType scheduler);
+
+    /**
+     * Places a file at a block, later reads of it seek there
+     * @param diskNumber : disk number
+     * @param fileName : file name
+     * @param block : block below blocks of the disk's model
+     */
+    void placeFile(int diskNumber, const std::string &fileName, unsigned long long block);
+
+    /**
+     * @param diskNumber : disk number
+     * @param file : interned file name
+     * @return : block of the file, files never placed get a fixed block derived from their name
+     */
+    unsigned long long getFileBlock(int diskNumber, FileId file) const;
+
+    /**
+     * @return : names of every file read or placed so far
+     */
+    const FileNameTable &getFileNames() const;
+
+    /**
+     * @param diskNumber : disk number
+     * @return : served requests, head movement and latency of the disk
+     */
+    const DiskStats &getDiskStats(int diskNumber) const;
+
+    /**
+     * @param diskNumber : disk number
+     * @return : geometry and timing of the disk
+     */
+    const DiskModel &getDiskModel(int diskNumber) const;
+
+    /**
+     * Moves virtual time forward, requests reaching an idle disk from now on start no earlier
+     * @param now : current virtual time
+     */
+    void advanceClock(unsigned long long now);
+
+    /**
+     * Starts caching the files disks finish reading, from now on
+     * @param capacity : number of files kept, 0 leaves caching off
+     * @param policy : policy choosing which file to drop
+     */
+    void enableFileCache(unsigned long long capacity, ReplacementPolicyType policy);
+
+    /**
+     * @return : file cache counters, all zero if caching is off
+     */
+    FileCacheStats getFileCacheStats() const;
+
+    /**
+     * Makes a read of a file already waiting for or being served by its disk join that read, from now on
+     */
+    void enableCoalescing();
 };
 
-#endif // DISK_MANAGER_HPP_
\ No newline at end of file
+#endif // DISK_MANAGER_HPP_
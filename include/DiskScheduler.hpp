@@ -0,0 +1,159 @@
+// Raed Abuzaid
+
+#ifndef DISK_SCHEDULER_HPP_
+#define DISK_SCHEDULER_HPP_
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "FileNameTable.hpp"
+#include "NodePool.hpp"
+
+struct FileReadRequest
+{
+    int PID{0};
+    std::string fileName{""};
+    unsigned long long block{0}; // position of the file on the disk
+
+    // Param Constructor
+    FileReadRequest(int pid = 0, std::string name = "", unsigned long long position = 0)
+        : PID{pid}, fileName{name}, block{position} {}
+};
+
+/**
+ * A read as the disks keep it, the file name stays interned until someone asks for it
+ */
+struct DiskRequest
+{
+    int PID{0};
+    FileId file{NO_FILE};
+    unsigned long long block{0}; // position of the file on the disk
+
+    // Param Constructor
+    DiskRequest(int pid = 0, FileId fileId = NO_FILE, unsigned long long position = 0)
+        : PID{pid}, file{fileId}, block{position} {}
+};
+
+enum class DiskSchedulerType
+{
+    FCFS,
+    SSTF,
+    SCAN,
+    C_LOOK
+};
+
+/**
+ * A request waiting for its disk
+ */
+struct QueuedRead
+{
+    DiskRequest request;
+    unsigned long long arrivalTime; // disk time the request was made
+    unsigned long long id;          // the caller's handle for the request
+};
+
+/**
+ * Decides which waiting request a disk serves next.
+ * Requests are kept in a map ordered by (position key, arrival); the position key is the block
+ * for every policy that looks at the head, so the next request is found with an O(log n) search
+ * around the head position. Map nodes never move, so the position of a request stays valid as a
+ * handle for cancelling it until it is served. Nodes come from a pool owned by the scheduler, so a
+ * queue that has been this long before pushes and pops without touching the heap.
+ */
+class DiskScheduler
+{
+public:
+    typedef std::pair<unsigned long long, unsigned long long> Key;
+    typedef std::map<Key, QueuedRead, std::less<Key>, PoolAllocator<std::pair<const Key, QueuedRead>>> Queue;
+    typedef Queue::iterator Handle;
+
+private:
+    NodePool nodes_;              // storage of the queue nodes, declared first so it outlives them
+    Queue queue_;
+    unsigned long long arrivals_; // orders requests on the same key
+    bool up_;                     // head is sweeping towards higher blocks
+
+    /**
+     * @param request : a request
+     * @return : the first half of its key in the queue
+     */
+    virtual unsigned long long positionKey(const DiskRequest &request) const;
+
+    /**
+     * Picks the request to serve next
+     * @param queue : waiting requests, not empty
+     * @param head : block under the head
+     * @param up : sweep direction, updated if the head turns around
+     * @param distance : set to the blocks the head travels to reach it
+     * @return : the request to serve
+     */
+    virtual Queue::const_iterator select(const Queue &queue, unsigned long long head, bool &up,
+                                         unsigned long long &distance) const = 0;
+
+public:
+    DiskScheduler();
+
+    virtual ~DiskScheduler() {}
+
+    DiskScheduler(const DiskScheduler &) = delete;
+    DiskScheduler &operator=(const DiskScheduler &) = delete;
+
+    /**
+     * Adds a request
+     * @param request : the request
+     * @param arrivalTime : disk time it was made
+     * @param id : the caller's handle for the request, handed back by pop
+     * @return : handle to cancel it with while it waits
+     */
+    Handle push(const DiskRequest &request, unsigned long long arrivalTime, unsigned long long id);
+
+    /**
+     * Removes the request to serve next, the queue must not be empty
+     * @param head : block under the head
+     * @param distance : set to the blocks the head travels to reach it
+     * @return : the request
+     */
+    QueuedRead pop(unsigned long long head, unsigned long long &distance);
+
+    /**
+     * Removes a waiting request
+     * @param handle : handle push returned for it
+     */
+    void erase(Handle handle);
+
+    /**
+     * Removes every waiting request
+     * @return : the requests in arrival order
+     */
+    std::vector<QueuedRead> drain();
+
+    /**
+     * @return : true if no request is waiting
+     */
+    bool empty() const;
+
+    /**
+     * @return : number of waiting requests
+     */
+    std::size_t size() const;
+
+    /**
+     * @param head : block under the head
+     * @return : waiting requests in the order they would be served if nothing else arrived
+     */
+    std::deque<QueuedRead> toDeque(unsigned long long head) const;
+};
+
+/**
+ * Creates a disk scheduler
+ * @param type : scheduler to create
+ * @param blocks : number of blocks on the disk
+ * @return : the new scheduler
+ */
+std::unique_ptr<DiskScheduler> makeDiskScheduler(DiskSchedulerType type, unsigned long long blocks);
+
+#endif // DISK_SCHEDULER_HPP_
@@ -0,0 +1,59 @@
+// Raed Abuzaid
+
+#ifndef DISK_SCHEDULERS_HPP_
+#define DISK_SCHEDULERS_HPP_
+
+#include "DiskScheduler.hpp"
+
+/**
+ * First come first served, the head position is ignored
+ */
+class FCFSDiskScheduler : public DiskScheduler
+{
+private:
+    unsigned long long positionKey(const DiskRequest &request) const override;
+    Queue::const_iterator select(const Queue &queue, unsigned long long head, bool &up,
+                                 unsigned long long &distance) const override;
+};
+
+/**
+ * Shortest seek time first, the nearest request on either side of the head
+ */
+class SSTFDiskScheduler : public DiskScheduler
+{
+private:
+    Queue::const_iterator select(const Queue &queue, unsigned long long head, bool &up,
+                                 unsigned long long &distance) const override;
+};
+
+/**
+ * Elevator. The head serves everything in its direction, travels on to the last block of the
+ * disk and only then turns around.
+ */
+class SCANDiskScheduler : public DiskScheduler
+{
+private:
+    unsigned long long lastBlock_;
+
+    Queue::const_iterator select(const Queue &queue, unsigned long long head, bool &up,
+                                 unsigned long long &distance) const override;
+
+public:
+    /**
+     * @param blocks : number of blocks on the disk
+     */
+    SCANDiskScheduler(unsigned long long blocks);
+};
+
+/**
+ * Circular LOOK. The head only serves requests on its way up; past the highest one it jumps
+ * back to the lowest waiting request.
+ */
+class CLOOKDiskScheduler : public DiskScheduler
+{
+private:
+    Queue::const_iterator select(const Queue &queue, unsigned long long head, bool &up,
+                                 unsigned long long &distance) const override;
+};
+
+#endif // DISK_SCHEDULERS_HPP_
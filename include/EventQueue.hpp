@@ -0,0 +1,92 @@
+// Raed Abuzaid
+
+#ifndef EVENT_QUEUE_HPP_
+#define EVENT_QUEUE_HPP_
+
+#include <vector>
+
+enum class EventType
+{
+    TIMER,      // quantum of the process on a core ran out
+    DISK_DONE,  // a disk finished the request in one of its slots
+    ACTION      // a scheduled action is due
+};
+
+struct Event
+{
+    unsigned long long time;     // virtual time the event happens at
+    unsigned long long sequence; // orders events at the same time by when they were scheduled
+    EventType type;
+    int target;                  // core, disk or action id
+    int slot;                    // slot of the disk, unused for other targets
+    unsigned long long stamp;    // state of the target when scheduled, a changed target makes the event stale
+};
+
+/**
+ * Pending events ordered by (time, sequence), so events at the same time come out in the order
+ * they were scheduled and a run never depends on heap layout.
+ * A 4-ary heap in a flat array: half the depth of a binary heap and the four children of a node
+ * share a cache line or two, which pays off because pops dominate.
+ */
+class EventQueue
+{
+private:
+    std::vector<Event> heap_;
+    unsigned long long sequence_;
+
+    /**
+     * @param a : an event
+     * @param b : an event
+     * @return : true if a happens before b
+     */
+    static bool before(const Event &a, const Event &b);
+
+    /**
+     * Moves an event towards the root until its parent happens before it
+     * @param index : position in the heap
+     */
+    void siftUp(std::size_t index);
+
+    /**
+     * Moves an event towards the leaves until it happens before all its children
+     * @param index : position in the heap
+     */
+    void siftDown(std::size_t index);
+
+public:
+    // Default constructor
+    EventQueue();
+
+    /**
+     * Schedules an event
+     * @param time : virtual time of the event
+     * @param type : kind of event
+     * @param target : core, disk or action id
+     * @param slot : slot of the disk, unused for other targets
+     * @param stamp : state of the target now
+     */
+    void push(unsigned long long time, EventType type, int target, int slot, unsigned long long stamp);
+
+    /**
+     * @return : the earliest event, the queue must not be empty
+     */
+    const Event &top() const;
+
+    /**
+     * Removes the earliest event, the queue must not be empty
+     * @return : the event
+     */
+    Event pop();
+
+    /**
+     * @return : true if no event is pending
+     */
+    bool empty() const;
+
+    /**
+     * @return : number of pending events, stale ones included
+     */
+    std::size_t size() const;
+};
+
+#endif // EVENT_QUEUE_HPP_
@@ -0,0 +1,67 @@
+// Raed Abuzaid
+
+#ifndef FILE_CACHE_HPP_
+#define FILE_CACHE_HPP_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "FileNameTable.hpp"
+#include "ReplacementPolicy.hpp"
+
+struct FileCacheStats
+{
+    unsigned long long hits{0};      // reads served without the disk
+    unsigned long long misses{0};    // reads that went to the disk
+    unsigned long long evictions{0}; // cached files dropped to make room
+};
+
+/**
+ * Recently read files, shared by every disk and keyed by (disk, file).
+ * A file is cached once a disk finishes reading it. Each cached file owns a slot, and slots are
+ * handed to a ReplacementPolicy exactly like frames of RAM, with the disk number in place of the
+ * pid and the file id in place of the page number, so any page replacement policy can pick victims.
+ */
+class FileCache
+{
+private:
+    unsigned long long capacity_;
+    std::unique_ptr<ReplacementPolicy> policy_;
+    std::unordered_map<unsigned long long, unsigned long long> slots_; // (disk, file) key -> slot
+    std::vector<unsigned long long> keys_;                              // slot -> (disk, file) key
+    FileCacheStats stats_;
+
+public:
+    /**
+     * @param capacity : number of files kept, at least 1
+     * @param policy : policy choosing which file to drop
+     */
+    FileCache(unsigned long long capacity, ReplacementPolicyType policy);
+
+    /**
+     * Looks up a file for a read and counts the hit or miss
+     * @param diskNumber : disk number
+     * @param file : interned file name
+     * @return : true if the file is cached
+     */
+    bool read(int diskNumber, FileId file);
+
+    /**
+     * Caches a file a disk just read, dropping another one if the cache is full
+     * @param diskNumber : disk number
+     * @param file : interned file name
+     */
+    void fill(int diskNumber, FileId file);
+
+    /**
+     * @return : number of cached files
+     */
+    unsigned long long size() const;
+
+    /**
+     * @return : hit, miss and eviction counters
+     */
+    const FileCacheStats &stats() const;
+};
+
+#endif // FILE_CACHE_HPP_
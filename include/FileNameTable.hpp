@@ -0,0 +1,55 @@
+// Raed Abuzaid
+
+#ifndef FILE_NAME_TABLE_HPP_
+#define FILE_NAME_TABLE_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef unsigned int FileId;
+
+constexpr FileId NO_FILE{0}; // the empty name, carried by idle disks
+
+/**
+ * Interned file names.
+ * Every distinct name is stored once and given a small dense id, so requests carry the id and
+ * only callers that want the text pay for it. Ids are never reused and stay valid for the
+ * lifetime of the table.
+ */
+class FileNameTable
+{
+private:
+    std::unordered_map<std::string, FileId> ids_;
+    std::vector<const std::string *> names_; // id -> key of ids_, map nodes never move
+    std::vector<unsigned long long> hashes_; // id -> hash of the name
+
+public:
+    // Default constructor
+    FileNameTable();
+
+    /**
+     * @param name : file name
+     * @return : id of the name, added to the table the first time it is seen
+     */
+    FileId intern(const std::string &name);
+
+    /**
+     * @param id : id returned by intern
+     * @return : the name
+     */
+    const std::string &name(FileId id) const;
+
+    /**
+     * @param id : id returned by intern
+     * @return : hash of the name, the same on every platform
+     */
+    unsigned long long hash(FileId id) const;
+
+    /**
+     * @return : number of distinct names, the empty name included
+     */
+    std::size_t size() const;
+};
+
+#endif // FILE_NAME_TABLE_HPP_
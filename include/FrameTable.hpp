@@ -0,0 +1,99 @@
+// Raed Abuzaid
+
+#ifndef FRAME_TABLE_HPP_
+#define FRAME_TABLE_HPP_
+
+#include <vector>
+#include "LRUList.hpp" // for NO_FRAME
+
+struct MemoryItem
+{
+    unsigned long long pageNumber;
+    unsigned long long frameNumber;
+    int PID; // PID of the process using this frame of memory
+
+    // Default Constructor
+    MemoryItem() : pageNumber(0), frameNumber(0), PID(-1) {}
+
+    MemoryItem(int pid, unsigned long long page, unsigned long long frame)
+        : pageNumber(page), frameNumber(frame), PID(pid) {}
+};
+
+using MemoryUsage = std::vector<MemoryItem>;
+
+/**
+ * Fixed-capacity table of RAM frames.
+ * Frames never move once handed out. Free frames are tracked in a multi-level bitmap,
+ * so the lowest free frame is found in a handful of word scans and released frames are
+ * reused without compacting anything. Slots are only materialized up to the highest
+ * frame ever used.
+ */
+class FrameTable
+{
+private:
+    unsigned long long capacity_; // number of frames in RAM
+    unsigned long long used_;     // number of occupied frames
+    std::vector<MemoryItem> frames_;
+    std::vector<std::vector<unsigned long long>> freeBits_; // level 0 has one bit per slot, set if free
+
+    /**
+     * Marks slot as free or occupied in the bitmap
+     * @param frame : frame number
+     * @param isFree : new state of the slot
+     */
+    void setFree(unsigned long long frame, bool isFree);
+
+    /**
+     * @return : lowest free slot below the high-water mark, NO_FRAME if there is none
+     */
+    unsigned long long lowestFree() const;
+
+public:
+    /**
+     * Creates an empty frame table
+     * @param capacity : number of frames in RAM
+     */
+    FrameTable(unsigned long long capacity);
+
+    /**
+     * Places a page in the lowest free frame
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : frame number used, NO_FRAME if RAM is full
+     */
+    unsigned long long allocate(int pid, unsigned long long pageNumber);
+
+    /**
+     * Frees an occupied frame
+     * @param frame : frame number
+     */
+    void release(unsigned long long frame);
+
+    /**
+     * @param frame : frame number
+     * @return : the frame's memory item
+     */
+    MemoryItem &operator[](unsigned long long frame);
+
+    /**
+     * @return : true if every frame is occupied
+     */
+    bool full() const;
+
+    /**
+     * @return : number of occupied frames
+     */
+    unsigned long long used() const;
+
+    /**
+     * @return : number of frames in RAM
+     */
+    unsigned long long capacity() const;
+
+    /**
+     * @return : occupied frames from low addresses to high
+     */
+    MemoryUsage occupied() const;
+};
+
+#endif // FRAME_TABLE_HPP_
@@ -0,0 +1,82 @@
+// Raed Abuzaid
+
+#ifndef LRU_LIST_HPP_
+#define LRU_LIST_HPP_
+
+#include <vector>
+
+constexpr unsigned long long NO_FRAME{~0ULL};
+
+/**
+ * Recency list over frame numbers.
+ * Links are kept in flat prev/next arrays indexed by frame number, closed into a ring
+ * through a sentinel slot, so touch, evict and unlink never walk the list.
+ */
+class LRUList
+{
+private:
+    std::vector<unsigned long long> prev_; // towards more recently used
+    std::vector<unsigned long long> next_; // towards less recently used, NO_FRAME if not linked
+    unsigned long long size_;
+
+    /**
+     * Grows the link arrays so that frame has a slot
+     * @param frame : frame number
+     */
+    void reserveFrame(unsigned long long frame);
+
+    /**
+     * Links a frame directly after the given slot
+     * @param slot : slot to link after
+     * @param frame : frame number
+     */
+    void linkAfter(unsigned long long slot, unsigned long long frame);
+
+public:
+    // Default constructor
+    LRUList();
+
+    /**
+     * Marks frame as most recently used, linking it if it is not in the list yet
+     * @param frame : frame number
+     */
+    void touch(unsigned long long frame);
+
+    /**
+     * Marks frame as least recently used, linking it if it is not in the list yet
+     * @param frame : frame number
+     */
+    void demote(unsigned long long frame);
+
+    /**
+     * Removes the least recently used frame from the list
+     * @return : evicted frame, NO_FRAME if list is empty
+     */
+    unsigned long long evict();
+
+    /**
+     * Removes the least recently used frame other than keep, keep stays where it was
+     * @param keep : frame to pass over, NO_FRAME for none
+     * @return : evicted frame, NO_FRAME if no other frame is in the list
+     */
+    unsigned long long evictExcept(unsigned long long keep);
+
+    /**
+     * Removes frame from the list, does nothing if frame is not linked
+     * @param frame : frame number
+     */
+    void unlink(unsigned long long frame);
+
+    /**
+     * @param frame : frame number
+     * @return : true if frame is in the list
+     */
+    bool contains(unsigned long long frame) const;
+
+    /**
+     * @return : number of frames in the list
+     */
+    unsigned long long size() const;
+};
+
+#endif // LRU_LIST_HPP_
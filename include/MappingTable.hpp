@@ -0,0 +1,113 @@
+// Raed Abuzaid
+
+#ifndef MAPPING_TABLE_HPP_
+#define MAPPING_TABLE_HPP_
+
+#include <unordered_map>
+#include <vector>
+#include "PageTable.hpp"
+
+constexpr unsigned long long NO_MAPPING{~0ULL};
+
+struct Mapping
+{
+    int PID;
+    unsigned long long pageNumber;
+    unsigned long long frameNumber;
+    unsigned long long prevInProcess; // NO_MAPPING at the head of the process chain
+    unsigned long long nextInProcess; // NO_MAPPING at the tail of the process chain
+    unsigned long long prevSharer;    // sharers of a frame form a ring
+    unsigned long long nextSharer;
+};
+
+/**
+ * Resident (PID, page) -> frame mappings.
+ * Every mapping is found through a PageTable index and sits on two chains: the chain of its
+ * process, so a process can be torn down without looking at anyone else's pages, and the ring of
+ * mappings sharing its frame, so a shared frame can be unmapped from every process at once.
+ * Without copy-on-write sharing each frame simply has a single mapping.
+ */
+class MappingTable
+{
+private:
+    PageTable index_; // (pid, page) -> mapping
+    std::vector<Mapping> mappings_;
+    std::vector<unsigned long long> freeMappings_;
+    std::unordered_map<int, unsigned long long> processHeads_; // pid -> first mapping of its chain
+    std::vector<unsigned long long> frameHeads_;               // frame -> oldest sharer
+    std::vector<unsigned int> sharerCounts_;                   // frame -> number of mappings
+
+    /**
+     * Appends a mapping to the sharer ring of a frame
+     * @param mapping : mapping id
+     * @param frame : frame number
+     */
+    void linkSharer(unsigned long long mapping, unsigned long long frame);
+
+    /**
+     * Takes a mapping out of the sharer ring of its frame
+     * @param mapping : mapping id
+     */
+    void unlinkSharer(unsigned long long mapping);
+
+public:
+    /**
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : mapping id, NO_MAPPING if the page is not resident
+     */
+    unsigned long long find(int pid, unsigned long long pageNumber) const;
+
+    /**
+     * @param mapping : mapping id
+     * @return : the mapping
+     */
+    const Mapping &operator[](unsigned long long mapping) const;
+
+    /**
+     * Maps a page that is not resident yet to a frame
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @param frame : frame number
+     * @return : new mapping id
+     */
+    unsigned long long map(int pid, unsigned long long pageNumber, unsigned long long frame);
+
+    /**
+     * Removes a mapping from the index and both of its chains
+     * @param mapping : mapping id
+     */
+    void unmap(unsigned long long mapping);
+
+    /**
+     * @param pid : process pid
+     * @return : first mapping of the process, NO_MAPPING if it has none
+     */
+    unsigned long long firstOfProcess(int pid) const;
+
+    /**
+     * @param mapping : mapping id
+     * @return : next mapping of the same process, NO_MAPPING at the end
+     */
+    unsigned long long nextOfProcess(unsigned long long mapping) const;
+
+    /**
+     * @param frame : frame number
+     * @return : oldest mapping of the frame, NO_MAPPING if it is not mapped
+     */
+    unsigned long long firstSharer(unsigned long long frame) const;
+
+    /**
+     * @param mapping : mapping id
+     * @return : next mapping of the same frame, NO_MAPPING after the newest
+     */
+    unsigned long long nextSharer(unsigned long long mapping) const;
+
+    /**
+     * @param frame : frame number
+     * @return : number of mappings of the frame
+     */
+    unsigned int sharers(unsigned long long frame) const;
+};
+
+#endif // MAPPING_TABLE_HPP_
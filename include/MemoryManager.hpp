@@ -3,55 +3,186 @@
 #ifndef MEMORY_MANAGER_HPP_
 #define MEMORY_MANAGER_HPP_
 
-#include <list>
-#include <map>
-#include <vector>
+#include <cstddef>
+#include <memory>
+#include "FrameTable.hpp"
+#include "MappingTable.hpp"
+#include "Prefetcher.hpp"
+#include "ReplacementPolicy.hpp"
+#include "StackDistanceAnalyzer.hpp"
+#include "TLB.hpp"
 
-struct MemoryItem
+struct CopyOnWriteStats
 {
-    unsigned long long pageNumber;
-    unsigned long long frameNumber;
-    int PID; // PID of the process using this frame of memory
-
-    // Default Constructor
-    MemoryItem() : pageNumber(0), frameNumber(0), PID(-1) {}
-
-    MemoryItem(int pid, unsigned long long page, unsigned long long frame)
-        : pageNumber(page), frameNumber(frame), PID(pid) {}
+    unsigned long long sharedPages{0}; // pages a fork mapped into a child without copying
+    unsigned long long copies{0};      // writes that broke the sharing of a page
 };
 
-using MemoryUsage = std::vector<MemoryItem>;
-
 class MemoryManager
 {
 private:
     unsigned long long pageSize_;
-    unsigned long long remainingMemory_;   // number of unsused frames left
-    std::list<unsigned long long> frames_; // from recent to least recent
-    std::map<std::pair<int, unsigned long long>, unsigned long long> pageTable_;
-    MemoryUsage memory_;
+    std::unique_ptr<ReplacementPolicy> policy_;
+    MappingTable mappings_; // resident pages of every process, several may share a frame
+    FrameTable memory_;
+    std::vector<TLB> tlbs_; // one per CPU
+    int pageShift_;         // log2 of the page size, -1 if it is not a power of two
+    std::vector<unsigned long long> pageBuffer_; // page numbers of the batch being applied
+    std::unique_ptr<StackDistanceAnalyzer> analyzer_; // only set when stack distance analysis is on
+    bool copyOnWriteFork_;                            // fork shares the parent's frames
+    CopyOnWriteStats copyOnWriteStats_;
+    std::unique_ptr<Prefetcher> prefetcher_;          // only set when prefetching is on
+    bool prefetchPending_;                            // the last access should move its stream along
+    std::vector<unsigned long long> prefetchPages_;   // pages proposed by the prefetcher
+
+    /**
+     * Makes sure a page is in RAM and records the access
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @param write : true if the access writes the page
+     * @param core : core making the access
+     * @return : frame holding the page, NO_FRAME if RAM has no frames
+     */
+    unsigned long long accessPage(int pid, unsigned long long pageNumber, bool write, int core);
+
+    /**
+     * Releases the frame chosen by the replacement policy, unmapping it from every sharer
+     */
+    void evictVictim();
+
+    /**
+     * Loads a page that was demanded but is not resident into a free frame, evicting a victim first if RAM is full
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @param core : core that faulted, its TLB caches the new translation
+     * @return : frame holding the page
+     */
+    unsigned long long loadPage(int pid, unsigned long long pageNumber, int core);
+
+    /**
+     * Loads the pages the prefetcher proposes after a miss or a first access to a prefetched page
+     * @param pid : process pid
+     * @param pageNumber : page just accessed
+     * @param frame : frame holding that page, it stays resident
+     */
+    void prefetch(int pid, unsigned long long pageNumber, unsigned long long frame);
+
+    /**
+     * Gives a writer its own copy of a shared page
+     * @param mapping : the writer's mapping of the shared frame
+     * @param core : core making the write
+     * @return : frame holding the private copy
+     */
+    unsigned long long copyOnWrite(unsigned long long mapping, int core);
+
+    /**
+     * Removes one mapping of a frame, the frame itself stays allocated
+     * @param mapping : mapping id
+     */
+    void unmapSharer(unsigned long long mapping);
+
+    /**
+     * Reports a frame under its oldest remaining sharer
+     * @param frame : frame number
+     */
+    void updateOwner(unsigned long long frame);
 
 public:
-    // Constructor
-    MemoryManager(unsigned long long amountOfRAM, unsigned int pageSize);
+    /**
+     * Constructor
+     * @param amountOfRAM : amount of memory
+     * @param pageSize : page size
+     * @param policy : page replacement policy
+     * @param tlbSets : sets in each TLB, 0 disables the TLB
+     * @param tlbWays : entries per TLB set
+     * @param cores : number of CPU cores, each gets its own TLB
+     */
+    MemoryManager(unsigned long long amountOfRAM, unsigned int pageSize,
+                  ReplacementPolicyType policy = ReplacementPolicyType::LRU,
+                  unsigned int tlbSets = 0, unsigned int tlbWays = 0, int cores = 1);
 
     /**
      * Allocates memory for process
      * @param pid : proces pid
      * @param address : process logical address
+     * @param write : true if the access writes the page, breaking copy-on-write sharing
+     * @param core : core making the access, its TLB is used
      */
-    void accessAddress(int pid, unsigned long long address);
+    void accessAddress(int pid, unsigned long long address, bool write = false, int core = 0);
 
     /**
-     * Deallocates all memory accociated with process pid
+     * Allocates memory for a run of accesses of one process, same result as calling accessAddress on each
      * @param pid : process pid
+     * @param addresses : process logical addresses, in access order
+     * @param count : number of addresses
+     * @param write : true if the accesses write their pages
+     * @param core : core making the accesses, its TLB is used
      */
-    void deallocateMemory(int pid);
+    void accessAddresses(int pid, const unsigned long long *addresses, std::size_t count, bool write = false,
+                         int core = 0);
 
     /**
-     * @return : memory vector
+     * Maps every resident page of the parent into the child, sharing the frames until one of them writes.
+     * Does nothing unless copy-on-write fork is enabled.
+     * @param parentPID : pid of the forking process
+     * @param childPID : pid of the new child
+     */
+    void forkMemory(int parentPID, int childPID);
+
+    /**
+     * Deallocates all memory accociated with a set of processes.
+     * Only the pages of those processes are visited, and every TLB is swept once for all of them.
+     * @param pids : the processes
+     * @param terminated : true at the index of every pid in pids
+     */
+    void deallocateMemory(const std::vector<int> &pids, const std::vector<bool> &terminated);
+
+    /**
+     * @return : memory vector, a shared frame has one item per process mapping it
      */
     MemoryUsage getMemoryUsage();
+
+    /**
+     * Makes forkMemory share the parent's frames with the child, from now on
+     */
+    void enableCopyOnWriteFork();
+
+    /**
+     * @return : pages shared by fork and copies made by writes
+     */
+    CopyOnWriteStats getCopyOnWriteStats() const;
+
+    /**
+     * Starts loading pages ahead of sequential or strided streams, from now on
+     * @param depth : pages to keep loaded ahead of a stream
+     * @param pressureDepth : pages to keep ahead when that means evicting resident pages
+     */
+    void enablePrefetching(unsigned int depth, unsigned int pressureDepth);
+
+    /**
+     * @return : prefetch counters, all zero if prefetching is off
+     */
+    PrefetchStats getPrefetchStats() const;
+
+    /**
+     * Starts feeding every access to a stack distance analyzer, from now on
+     */
+    void enableStackDistanceAnalysis();
+
+    /**
+     * @return : the stack distance analyzer, nullptr if analysis is off
+     */
+    const StackDistanceAnalyzer *getStackDistanceAnalyzer() const;
+
+    /**
+     * @return : hit, miss and eviction counters of the replacement policy
+     */
+    ReplacementStats getReplacementStats() const;
+
+    /**
+     * @return : hit, miss and invalidation counters summed over every TLB
+     */
+    TLBStats getTLBStats() const;
 };
 
 #endif // MEMORY_MANAGER_HPP_
\ No newline at end of file
@@ -0,0 +1,99 @@
+// Raed Abuzaid
+
+#ifndef NODE_POOL_HPP_
+#define NODE_POOL_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * Fixed size nodes carved out of chunks and recycled through a free list.
+ * The node size is set by the first allocation; a node-based container allocates nothing
+ * but its nodes one at a time, so once it has held as many elements as it ever will again,
+ * inserting and erasing only move nodes on and off the free list. Chunks are kept until the
+ * pool is destroyed.
+ */
+class NodePool
+{
+private:
+    std::vector<std::unique_ptr<unsigned char[]>> chunks_;
+    void *free_;              // first free node, each free node holds the next
+    std::size_t nodeSize_;    // 0 until the first allocation
+    std::size_t chunkNodes_;  // nodes in the next chunk, doubles up to a limit
+
+    /**
+     * @param bytes : requested size
+     * @return : size of a node holding it
+     */
+    static std::size_t roundUp(std::size_t bytes);
+
+public:
+    // Default constructor
+    NodePool();
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    /**
+     * @param bytes : size of the object
+     * @return : storage for it, from the pool if it has the node size, else from the heap
+     */
+    void *allocate(std::size_t bytes);
+
+    /**
+     * @param node : storage allocate returned
+     * @param bytes : size passed to allocate
+     */
+    void deallocate(void *node, std::size_t bytes);
+};
+
+/**
+ * Allocator handing single objects out of a NodePool, for node-based standard containers.
+ * Copies and rebinds share the pool, which must outlive every container using it.
+ */
+template <typename T>
+struct PoolAllocator
+{
+    typedef T value_type;
+
+    NodePool *pool;
+
+    // Param constructor
+    explicit PoolAllocator(NodePool *nodePool) : pool(nodePool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {}
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(n == 1 ? pool->allocate(sizeof(T)) : ::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *object, std::size_t n)
+    {
+        if (n == 1)
+        {
+            pool->deallocate(object, sizeof(T));
+        }
+        else
+        {
+            ::operator delete(object);
+        }
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T> &a, const PoolAllocator<U> &b)
+{
+    return a.pool == b.pool;
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T> &a, const PoolAllocator<U> &b)
+{
+    return a.pool != b.pool;
+}
+
+#endif // NODE_POOL_HPP_
@@ -0,0 +1,104 @@
+// Raed Abuzaid
+
+#ifndef PAGE_TABLE_HPP_
+#define PAGE_TABLE_HPP_
+
+#include <vector>
+
+/**
+ * Open-addressing hash map from (PID, page number) to frame number.
+ * Uses Robin Hood linear probing with backward-shift deletion, so there are no tombstones
+ * and insert, lookup and erase never allocate once the table has grown to its working size.
+ */
+class PageTable
+{
+private:
+    struct Slot
+    {
+        unsigned long long pageNumber;
+        unsigned long long frameNumber;
+        int PID;
+        unsigned int distance; // probe distance + 1, 0 marks an empty slot
+
+        // Default constructor
+        Slot() : pageNumber(0), frameNumber(0), PID(0), distance(0) {}
+    };
+
+    std::vector<Slot> slots_;
+    unsigned long long mask_;
+    unsigned long long size_;
+
+    /**
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : home slot of the key
+     */
+    unsigned long long hash(int pid, unsigned long long pageNumber) const;
+
+    /**
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : index of the slot holding the key, slots_.size() if absent
+     */
+    unsigned long long findSlot(int pid, unsigned long long pageNumber) const;
+
+    /**
+     * Rehashes every entry into a table with the given number of slots
+     * @param capacity : new slot count, power of two
+     */
+    void rehash(unsigned long long capacity);
+
+public:
+    /**
+     * Creates an empty page table
+     * @param expectedEntries : number of entries to size the table for
+     */
+    PageTable(unsigned long long expectedEntries = 0);
+
+    /**
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : pointer to the mapped frame number, nullptr if the page is not mapped
+     */
+    const unsigned long long *find(int pid, unsigned long long pageNumber) const;
+
+    /**
+     * Maps a page to a frame, replacing any existing mapping
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @param frameNumber : frame number
+     */
+    void insert(int pid, unsigned long long pageNumber, unsigned long long frameNumber);
+
+    /**
+     * Removes the mapping of a page
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : true if a mapping was removed
+     */
+    bool erase(int pid, unsigned long long pageNumber);
+
+    /**
+     * @return : number of mapped pages
+     */
+    unsigned long long size() const;
+
+    /**
+     * Calls visit(pid, pageNumber, frameNumber) for every mapping, in no particular order.
+     * The frame number is passed by reference and may be changed, the table must not be.
+     * @param visit : visitor
+     */
+    template <typename Visitor>
+    void forEach(Visitor visit)
+    {
+        for (Slot &slot : slots_)
+        {
+            if (slot.distance != 0)
+            {
+                visit(slot.PID, slot.pageNumber, slot.frameNumber);
+            }
+        }
+    }
+};
+
+#endif // PAGE_TABLE_HPP_
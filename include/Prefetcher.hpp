@@ -0,0 +1,118 @@
+// Raed Abuzaid
+
+#ifndef PREFETCHER_HPP_
+#define PREFETCHER_HPP_
+
+#include <unordered_map>
+#include <vector>
+
+struct PrefetchStats
+{
+    unsigned long long issued{0};    // pages loaded ahead of use
+    unsigned long long useful{0};    // prefetched pages accessed before leaving RAM, accuracy = useful / issued
+    unsigned long long wasted{0};    // prefetched pages evicted or freed without an access
+    unsigned long long throttled{0}; // pages held back because the window did not fit in free frames
+};
+
+/**
+ * Per-process sequential and strided stream detector.
+ * It only looks at demand misses and first accesses to prefetched pages. Each process tracks a few
+ * streams so unrelated misses don't break one off; a page near a stream's last page continues it,
+ * anything else replaces the least recently used stream. Two equal steps in a row confirm a
+ * stream, and the pages ahead along it are proposed, never more than depth pages past the current
+ * one. When the window does not fit in the free frames it shrinks to pressureDepth, or to what does
+ * fit if that is more, so at most pressureDepth resident pages are evicted for it; it stops evicting
+ * entirely while recent prefetches are mostly wasted.
+ */
+class Prefetcher
+{
+private:
+    struct Stream
+    {
+        unsigned long long lastPage{0};
+        long long stride{0};
+        unsigned long long frontier{0}; // furthest page already proposed along the stride
+        unsigned long long lastUse{0};  // 0 marks an unused entry
+    };
+
+    static constexpr int STREAMS_PER_PROCESS = 4;
+
+    struct ProcessStreams
+    {
+        Stream streams[STREAMS_PER_PROCESS];
+    };
+
+    unsigned int depth_;
+    unsigned int pressureDepth_;
+    std::unordered_map<int, ProcessStreams> streams_;
+    unsigned long long clock_; // stamps stream use
+    std::vector<bool> prefetched_; // per frame, holds a prefetched page nobody accessed yet
+    PrefetchStats stats_;
+    unsigned long long recentUseful_; // decayed counts behind the throttle
+    unsigned long long recentWasted_;
+    unsigned long long heldBack_;     // triggers the throttle stopped
+
+    /**
+     * Records how a prefetched page ended up, for the throttle
+     * @param useful : true if it was accessed
+     */
+    void resolve(bool useful);
+
+    /**
+     * @param streams : streams of one process
+     * @param pageNumber : page just accessed
+     * @return : stream the page belongs to, a recycled one if none is close
+     */
+    Stream &match(ProcessStreams &streams, unsigned long long pageNumber);
+
+public:
+    /**
+     * @param depth : pages to keep loaded ahead of a stream
+     * @param pressureDepth : pages to keep ahead when that means evicting resident pages
+     * @param capacity : number of frames in RAM, at most half of them are used for one window
+     */
+    Prefetcher(unsigned int depth, unsigned int pressureDepth, unsigned long long capacity);
+
+    /**
+     * Trains the stream of a process on a demand miss or first access to a prefetched page
+     * and proposes the pages to load next
+     * @param pid : process pid
+     * @param pageNumber : page just accessed
+     * @param freeFrames : frames not holding any page
+     * @param pages : filled with the proposed pages, nearest first
+     */
+    void plan(int pid, unsigned long long pageNumber, unsigned long long freeFrames,
+              std::vector<unsigned long long> &pages);
+
+    /**
+     * Records that a prefetched page was loaded into frame
+     * @param frame : frame number
+     */
+    void loaded(unsigned long long frame);
+
+    /**
+     * Called on every access to a resident frame
+     * @param frame : frame number
+     * @return : true if this was the first access to a prefetched page
+     */
+    bool accessed(unsigned long long frame);
+
+    /**
+     * Called when a frame is evicted or freed
+     * @param frame : frame number
+     */
+    void released(unsigned long long frame);
+
+    /**
+     * Forgets the stream of a process
+     * @param pid : process pid
+     */
+    void forget(int pid);
+
+    /**
+     * @return : prefetch counters
+     */
+    const PrefetchStats &stats() const;
+};
+
+#endif // PREFETCHER_HPP_
@@ -4,42 +4,34 @@
 #ifndef PROCESS_MANAGER_HPP_
 #define PROCESS_MANAGER_HPP_
 
-#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "CPU.hpp"
 #include "DiskManager.hpp"
 #include "MemoryManager.hpp"
-
-struct Process
-{
-    int PID;
-    int parentPID;
-    std::vector<int> childrenPIDs;
-    bool isZombie;
-    bool isWaiting;
-    bool requestedReading;
-
-    // Default constructor
-    Process() : PID(-1), parentPID(-1), isZombie(false), isWaiting(false) {}
-
-    Process(int pid, int parentPid = -1)
-        : PID(pid), parentPID(parentPid), isZombie(0), isWaiting(0) {}
-};
+#include "ProcessTable.hpp"
 
 class ProcessManager
 {
 private:
     int nextPID_;
-    std::unordered_map<int, Process> processes_;
+    ProcessTable processes_;
+    std::vector<int> subtree_;      // process being terminated followed by its descendants
+    std::vector<bool> terminating_; // by pid, true for every process in subtree_
 
     /**
-     * Cascading terminate to prevent orphans when a process is terminated
+     * Collects a process and all its descendants into subtree_ and terminating_, without recursion
+     * so fork chains of any depth are safe
      * @param pid : process pid
-     * @param cpu : refrence to cpu
-     * @param diskManager : refrence to disk manager
-     * @param memoryManager : refrence to memory manager
      */
-    void cascadingTerminate(int pid, CPU &cpu, MemoryManager &memoryManager, DiskManager &diskManager);
+    void collectSubtree(int pid);
+
+    /**
+     * Takes a child out of its parent's children
+     * @param parent : the parent
+     * @param child : one of its children
+     */
+    void unlinkChild(Process &parent, Process &child);
 
 public:
     /**
@@ -48,7 +40,7 @@ public:
     ProcessManager();
 
     /**
-     * Creates a process, adds it to processes map, increments pid
+     * Creates a process, adds it to the process table, increments pid
      * @return : PID of new process
      */
     int createProcess();
@@ -62,6 +54,7 @@ public:
 
     /**
      * Terminates process, as well as all decendent processes
+     * Each subsystem releases the whole subtree in a single call, so the cost is linear in the subtree and its resources
      * If parent is waiting automatically terminate, else process becomes zombie
      * @param pid : PID of process
      * @param cpu : refrence to cpu
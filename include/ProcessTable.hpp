@@ -0,0 +1,112 @@
+// Raed Abuzaid
+
+#ifndef PROCESS_TABLE_HPP_
+#define PROCESS_TABLE_HPP_
+
+#include <memory>
+#include <vector>
+
+constexpr int NO_PID{-1};
+
+/**
+ * A process and its place in the process tree. Children form a doubly linked list in creation order
+ * through their sibling links, and zombie children also form a list of their own, so adding, unlinking
+ * and reaping a child are O(1) and a record needs no heap memory.
+ */
+struct Process
+{
+    int PID;
+    int parentPID;
+    int firstChild;  // oldest child, NO_PID if none
+    int lastChild;   // newest child
+    int prevSibling; // siblings in creation order
+    int nextSibling;
+    int firstZombie; // zombie children waiting to be reaped
+    int nextZombie;  // next zombie of the same parent
+    bool isZombie;
+    bool isWaiting;
+    bool requestedReading;
+
+    // Default constructor
+    Process()
+        : PID(NO_PID), parentPID(NO_PID), firstChild(NO_PID), lastChild(NO_PID), prevSibling(NO_PID),
+          nextSibling(NO_PID), firstZombie(NO_PID), nextZombie(NO_PID), isZombie(false), isWaiting(false),
+          requestedReading(false) {}
+
+    Process(int pid, int parentPid = NO_PID)
+        : PID(pid), parentPID(parentPid), firstChild(NO_PID), lastChild(NO_PID), prevSibling(NO_PID),
+          nextSibling(NO_PID), firstZombie(NO_PID), nextZombie(NO_PID), isZombie(0), isWaiting(0),
+          requestedReading(false) {}
+};
+
+/**
+ * Process records indexed directly by PID.
+ * PIDs are handed out in increasing order, so records live in fixed size chunks of consecutive PIDs
+ * found through a directory: a lookup is two array indexes and a live bit, with no hashing. Records
+ * never move, so references stay valid until the process is erased. Once every PID of a chunk has
+ * been handed out and erased the chunk goes back to a pool and is reused for later PIDs, which keeps
+ * memory proportional to the processes alive rather than to every PID ever used.
+ */
+class ProcessTable
+{
+private:
+    static constexpr int CHUNK_BITS = 10;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_BITS;
+
+    struct Chunk
+    {
+        Process records[CHUNK_SIZE];
+        unsigned long long live[CHUNK_SIZE / 64]; // bit per record in use
+        int count;                                // records in use
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks_; // by PID >> CHUNK_BITS, null if never used or recycled
+    std::vector<std::unique_ptr<Chunk>> spare_;  // recycled chunks
+    int highestPID_;                             // largest PID ever created
+    std::size_t size_;
+
+    /**
+     * @param pid : process pid
+     * @return : chunk holding the pid, nullptr if it has none
+     */
+    Chunk *chunkOf(int pid) const;
+
+public:
+    // Default constructor
+    ProcessTable();
+
+    /**
+     * Adds a record, pids must be created in increasing order
+     * @param pid : process pid
+     * @param parentPID : parent pid, NO_PID for none
+     * @return : the new record
+     */
+    Process &create(int pid, int parentPID = NO_PID);
+
+    /**
+     * @param pid : process pid
+     * @return : record of the process, nullptr if it does not exist
+     */
+    Process *find(int pid);
+
+    /**
+     * Record of a process that must exist
+     * @param pid : process pid
+     * @return : record of the process
+     */
+    Process &get(int pid);
+
+    /**
+     * Removes a record, recycling its chunk if nothing in it can be used again
+     * @param pid : process pid
+     * @return : true if the record existed
+     */
+    bool erase(int pid);
+
+    /**
+     * @return : number of records
+     */
+    std::size_t size() const;
+};
+
+#endif // PROCESS_TABLE_HPP_
@@ -0,0 +1,110 @@
+// Raed Abuzaid
+
+#ifndef READY_QUEUE_HPP_
+#define READY_QUEUE_HPP_
+
+#include <deque>
+#include <vector>
+
+constexpr int NO_PROCESS{0};
+
+/**
+ * A fixed number of FIFO queues of PIDs, with insertion at either end and removal from anywhere.
+ * Links live in flat prev/next arrays indexed by PID and every queue is closed into a ring
+ * through its own sentinel slot, so a PID is in at most one queue and enqueue, dequeue at
+ * either end and removal never walk a queue.
+ */
+class ReadyQueue
+{
+private:
+    std::vector<int> prev_;  // towards the front
+    std::vector<int> next_;  // towards the back, NOT_QUEUED if the pid is not in any queue
+    std::vector<int> queue_; // per slot, queue holding it
+    std::vector<std::size_t> sizes_;
+
+    /**
+     * @param pid : process pid
+     * @return : slot of the pid in the link arrays
+     */
+    int slot(int pid) const;
+
+    /**
+     * Links a process into a queue at either end, moving it there if it is already queued
+     * @param pid : process pid, negative pids are ignored
+     * @param queue : queue index
+     * @param front : true to link it at the front, false at the back
+     */
+    void link(int pid, std::size_t queue, bool front);
+
+public:
+    /**
+     * @param queues : number of queues
+     */
+    ReadyQueue(std::size_t queues = 1);
+
+    /**
+     * Adds a process to the back of a queue, moving it there if it is already queued
+     * @param pid : process pid, negative pids are ignored
+     * @param queue : queue index
+     */
+    void pushBack(int pid, std::size_t queue = 0);
+
+    /**
+     * Adds a process to the front of a queue, moving it there if it is already queued
+     * @param pid : process pid, negative pids are ignored
+     * @param queue : queue index
+     */
+    void pushFront(int pid, std::size_t queue = 0);
+
+    /**
+     * Removes the process at the front of a queue
+     * @param queue : queue index
+     * @return : its pid, NO_PROCESS if the queue is empty
+     */
+    int popFront(std::size_t queue = 0);
+
+    /**
+     * Removes the process at the back of a queue
+     * @param queue : queue index
+     * @return : its pid, NO_PROCESS if the queue is empty
+     */
+    int popBack(std::size_t queue = 0);
+
+    /**
+     * Removes a process from whichever queue holds it, does nothing if it is not queued
+     * @param pid : process pid
+     */
+    void remove(int pid);
+
+    /**
+     * @param pid : process pid
+     * @return : true if the process is queued
+     */
+    bool contains(int pid) const;
+
+    /**
+     * @param pid : process pid
+     * @return : queue holding the process, -1 if it is not queued
+     */
+    int queueOf(int pid) const;
+
+    /**
+     * @param queue : queue index
+     * @return : true if no process is in the queue
+     */
+    bool empty(std::size_t queue = 0) const;
+
+    /**
+     * @param queue : queue index
+     * @return : number of processes in the queue
+     */
+    std::size_t size(std::size_t queue = 0) const;
+
+    /**
+     * @param queue : queue index
+     * @return : pids of the queue from front to back
+     */
+    std::deque<int> toDeque(std::size_t queue = 0) const;
+};
+
+#endif // READY_QUEUE_HPP_
@@ -0,0 +1,236 @@
+// Raed Abuzaid
+
+#ifndef REPLACEMENT_POLICIES_HPP_
+#define REPLACEMENT_POLICIES_HPP_
+
+#include <map>
+#include <vector>
+#include "LRUList.hpp"
+#include "PageTable.hpp"
+#include "ReplacementPolicy.hpp"
+
+/**
+ * Bounded recency list of pages that were recently evicted (ARC and 2Q history).
+ * Entries are found through a PageTable and ordered through an LRUList over entry slots.
+ */
+class GhostList
+{
+private:
+    struct Entry
+    {
+        int PID;
+        unsigned long long pageNumber;
+    };
+
+    PageTable index_; // (pid, page) -> slot
+    std::vector<Entry> entries_;
+    std::vector<unsigned long long> freeSlots_;
+    LRUList order_; // slots from newest to oldest
+
+public:
+    /**
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : true if the page is remembered
+     */
+    bool contains(int pid, unsigned long long pageNumber) const;
+
+    /**
+     * Remembers a page as the newest entry
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    void push(int pid, unsigned long long pageNumber);
+
+    /**
+     * Forgets a page
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : true if the page was remembered
+     */
+    bool erase(int pid, unsigned long long pageNumber);
+
+    /**
+     * Forgets the oldest page, does nothing if the list is empty
+     */
+    void dropOldest();
+
+    /**
+     * @return : number of remembered pages
+     */
+    unsigned long long size() const;
+};
+
+/**
+ * Exact least recently used replacement
+ */
+class LRUPolicy : public ReplacementPolicy
+{
+private:
+    LRUList frames_; // from recent to least recent
+
+    void onHit(unsigned long long frame) override;
+    unsigned long long selectVictim() override;
+    void onInsert(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onRemove(unsigned long long frame) override;
+};
+
+/**
+ * CLOCK: a hand sweeps the frames in frame order, clearing reference bits until it finds
+ * an unreferenced frame. A hit only sets a bit.
+ */
+class ClockPolicy : public ReplacementPolicy
+{
+private:
+    std::vector<unsigned char> state_; // per frame, NOT_RESIDENT, RESIDENT or REFERENCED
+    unsigned long long hand_;
+
+    void onHit(unsigned long long frame) override;
+    unsigned long long selectVictim() override;
+    void onInsert(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onRemove(unsigned long long frame) override;
+
+public:
+    // Default constructor
+    ClockPolicy();
+};
+
+/**
+ * Second chance: FIFO order of arrival, a referenced frame at the head of the queue is
+ * moved to the tail with its bit cleared instead of being replaced.
+ */
+class SecondChancePolicy : public ReplacementPolicy
+{
+private:
+    LRUList queue_; // arrival order, newest first
+    std::vector<bool> referenced_;
+
+    void onHit(unsigned long long frame) override;
+    unsigned long long selectVictim() override;
+    void onInsert(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onRemove(unsigned long long frame) override;
+};
+
+/**
+ * Least frequently used, ties broken by least recent use.
+ * Frames with the same use count share a bucket; buckets are ordered by count so the
+ * victim bucket is always the first one.
+ */
+class LFUPolicy : public ReplacementPolicy
+{
+private:
+    struct Bucket
+    {
+        unsigned long long newest{NO_FRAME};
+        unsigned long long oldest{NO_FRAME};
+    };
+
+    std::map<unsigned long long, Bucket> buckets_; // use count -> frames with that count
+    std::vector<unsigned long long> count_;        // per frame, 0 if not resident
+    std::vector<unsigned long long> newer_;
+    std::vector<unsigned long long> older_;
+    std::vector<bool> cold_;                       // per frame, prefetched and not accessed yet
+
+    /**
+     * Links frame as the newest entry of the bucket for its count
+     * @param frame : frame number
+     */
+    void link(unsigned long long frame);
+
+    /**
+     * Links frame as the oldest entry of the bucket for its count
+     * @param frame : frame number
+     */
+    void linkOldest(unsigned long long frame);
+
+    /**
+     * Unlinks frame from the bucket for its count, dropping the bucket if it empties
+     * @param frame : frame number
+     */
+    void unlink(unsigned long long frame);
+
+    void onHit(unsigned long long frame) override;
+    void onRepeatedHits(unsigned long long frame, unsigned long long count) override;
+    unsigned long long selectVictim() override;
+    void onInsert(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onRemove(unsigned long long frame) override;
+};
+
+/**
+ * Adaptive Replacement Cache (Megiddo and Modha).
+ * T1 holds pages seen once recently, T2 pages seen at least twice; B1 and B2 remember pages
+ * evicted from each. Hits in the ghost lists move the target size p of T1.
+ */
+class ARCPolicy : public ReplacementPolicy
+{
+private:
+    unsigned long long capacity_;
+    unsigned long long target_; // p, target size of T1
+    LRUList recent_;            // T1
+    LRUList frequent_;          // T2
+    GhostList recentGhosts_;    // B1
+    GhostList frequentGhosts_;  // B2
+    std::vector<int> pids_;     // per frame
+    std::vector<unsigned long long> pages_;
+    std::vector<bool> cold_;    // per frame, prefetched and not accessed yet
+    bool missedInFrequentGhosts_;
+    bool promoteMiss_; // last missed page goes straight to T2
+
+    /**
+     * @param frame : frame number
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    void remember(unsigned long long frame, int pid, unsigned long long pageNumber);
+
+    void onHit(unsigned long long frame) override;
+    void onMiss(int pid, unsigned long long pageNumber) override;
+    unsigned long long selectVictim() override;
+    void onInsert(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onRemove(unsigned long long frame) override;
+
+public:
+    /**
+     * @param capacity : number of frames in RAM
+     */
+    ARCPolicy(unsigned long long capacity);
+};
+
+/**
+ * Full 2Q (Johnson and Shasha).
+ * New pages enter the FIFO A1in, pages evicted from it are remembered in A1out, and only a
+ * page missed again while in A1out is promoted to the LRU list Am.
+ */
+class TwoQueuePolicy : public ReplacementPolicy
+{
+private:
+    unsigned long long inCapacity_;  // Kin, about a quarter of RAM
+    unsigned long long outCapacity_; // Kout, remembered pages, about half of RAM
+    LRUList in_;                     // A1in, arrival order
+    LRUList main_;                   // Am, recency order
+    GhostList out_;                  // A1out
+    std::vector<int> pids_;          // per frame
+    std::vector<unsigned long long> pages_;
+    std::vector<bool> cold_;         // per frame, prefetched and not accessed yet
+    bool promoteMiss_; // last missed page goes straight to Am
+
+    void onHit(unsigned long long frame) override;
+    void onMiss(int pid, unsigned long long pageNumber) override;
+    unsigned long long selectVictim() override;
+    void onInsert(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber) override;
+    void onRemove(unsigned long long frame) override;
+
+public:
+    /**
+     * @param capacity : number of frames in RAM
+     */
+    TwoQueuePolicy(unsigned long long capacity);
+};
+
+#endif // REPLACEMENT_POLICIES_HPP_
@@ -0,0 +1,168 @@
+// Raed Abuzaid
+
+#ifndef REPLACEMENT_POLICY_HPP_
+#define REPLACEMENT_POLICY_HPP_
+
+#include <memory>
+#include "LRUList.hpp"
+
+enum class ReplacementPolicyType
+{
+    LRU,
+    CLOCK,
+    SECOND_CHANCE,
+    LFU,
+    ARC,
+    TWO_Q
+};
+
+struct ReplacementStats
+{
+    unsigned long long hits{0};
+    unsigned long long misses{0};
+    unsigned long long evictions{0};
+};
+
+/**
+ * Decides which resident frame gives way when RAM is full.
+ * MemoryManager reports every hit, miss, placement and release; the policy only keeps
+ * whatever bookkeeping it needs to pick a victim. Counters are kept here so every policy
+ * reports them the same way.
+ */
+class ReplacementPolicy
+{
+private:
+    ReplacementStats stats_;
+    unsigned long long pinned_; // frame evict must not choose, NO_FRAME if none
+
+    /**
+     * Resident page in frame was accessed
+     * @param frame : frame number
+     */
+    virtual void onHit(unsigned long long frame) = 0;
+
+    /**
+     * Resident page in frame was accessed several times in a row, with nothing in between.
+     * Counts as one hit unless the policy keeps a count, only the first hit of a run changes recency.
+     * @param frame : frame number
+     * @param count : number of accesses
+     */
+    virtual void onRepeatedHits(unsigned long long frame, unsigned long long count);
+
+    /**
+     * A page that is not resident was accessed, called before any eviction for it
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    virtual void onMiss(int pid, unsigned long long pageNumber);
+
+    /**
+     * Picks a resident frame and forgets it
+     * @return : frame to replace
+     */
+    virtual unsigned long long selectVictim() = 0;
+
+    /**
+     * The page from the last miss now lives in frame
+     * @param frame : frame number
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    virtual void onInsert(unsigned long long frame, int pid, unsigned long long pageNumber) = 0;
+
+    /**
+     * A page nobody asked for yet (a prefetch) now lives in frame, it should be among the first to go
+     * @param frame : frame number
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    virtual void onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber);
+
+    /**
+     * Frame was released without being chosen as a victim
+     * @param frame : frame number
+     */
+    virtual void onRemove(unsigned long long frame) = 0;
+
+protected:
+    /**
+     * @return : frame selectVictim must pass over, NO_FRAME if none
+     */
+    unsigned long long pinned() const;
+
+public:
+    // Default constructor
+    ReplacementPolicy();
+
+    virtual ~ReplacementPolicy() {}
+
+    /**
+     * Records an access to a resident page
+     * @param frame : frame number
+     */
+    void hit(unsigned long long frame);
+
+    /**
+     * Records several back to back accesses to a resident page
+     * @param frame : frame number
+     * @param count : number of accesses
+     */
+    void hit(unsigned long long frame, unsigned long long count);
+
+    /**
+     * Records an access to a page that must be loaded
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    void miss(int pid, unsigned long long pageNumber);
+
+    /**
+     * Chooses the frame to replace, RAM must be full
+     * @return : frame to replace
+     */
+    unsigned long long evict();
+
+    /**
+     * Keeps frame resident through the following evictions, until another frame is pinned.
+     * At least one other frame must be resident whenever evict is called.
+     * @param frame : frame number, NO_FRAME releases the pin
+     */
+    void pin(unsigned long long frame);
+
+    /**
+     * Records that the missed page was placed in frame
+     * @param frame : frame number
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    void insert(unsigned long long frame, int pid, unsigned long long pageNumber);
+
+    /**
+     * Records that a prefetched page was placed in frame, at the lowest priority
+     * @param frame : frame number
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    void insertCold(unsigned long long frame, int pid, unsigned long long pageNumber);
+
+    /**
+     * Records that frame was released by its process
+     * @param frame : frame number
+     */
+    void remove(unsigned long long frame);
+
+    /**
+     * @return : hit, miss and eviction counters
+     */
+    const ReplacementStats &stats() const;
+};
+
+/**
+ * Creates a replacement policy
+ * @param type : policy to create
+ * @param capacity : number of frames in RAM
+ * @return : the new policy
+ */
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(ReplacementPolicyType type, unsigned long long capacity);
+
+#endif // REPLACEMENT_POLICY_HPP_
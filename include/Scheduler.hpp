@@ -0,0 +1,126 @@
+// Raed Abuzaid
+
+#ifndef SCHEDULER_HPP_
+#define SCHEDULER_HPP_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+constexpr int PRIORITY_LEVELS{40};  // priorities run from 0, the highest, to PRIORITY_LEVELS - 1
+constexpr int DEFAULT_PRIORITY{20}; // priority of a process nobody set one for
+
+enum class SchedulerType
+{
+    ROUND_ROBIN,
+    PRIORITY,
+    MLFQ,
+    FAIR
+};
+
+/**
+ * Why a process is handed to the scheduler
+ */
+enum class ReadyReason
+{
+    CREATED,   // new or forked process
+    WOKEN,     // its disk read completed or its wait is over
+    EXPIRED,   // its time slice ran out
+    PREEMPTED  // a process the scheduler prefers took its core before the slice ran out
+};
+
+/**
+ * Decides which ready process each core runs next.
+ * Every core has its own ready queue inside the scheduler, CPU picks the core a process goes
+ * to and the scheduler orders the processes within it. Per-process state, like a priority, is
+ * kept here so it follows a process from core to core.
+ */
+class Scheduler
+{
+private:
+    std::vector<int> priorities_; // per pid
+
+    /**
+     * The priority of a process changed
+     * @param pid : process pid
+     */
+    virtual void onPriorityChange(int pid);
+
+public:
+    virtual ~Scheduler() {}
+
+    /**
+     * Makes a process ready on a core
+     * @param pid : process pid
+     * @param core : core index
+     * @param reason : why it became ready
+     */
+    virtual void enqueue(int pid, int core, ReadyReason reason) = 0;
+
+    /**
+     * Removes the process a core should run next
+     * @param core : core index
+     * @return : its pid, NO_PROCESS if the core has nothing ready
+     */
+    virtual int pickNext(int core) = 0;
+
+    /**
+     * Removes the process of a core that another, idle, core should take
+     * @param core : core to take it from
+     * @return : its pid, NO_PROCESS if the core has nothing ready
+     */
+    virtual int steal(int core) = 0;
+
+    /**
+     * Removes a process from whichever core it is ready on, does nothing if it is not ready
+     * @param pid : process pid
+     */
+    virtual void remove(int pid) = 0;
+
+    /**
+     * @param pid : process that just became ready
+     * @param running : process running on its core
+     * @return : true if pid should take the core right away
+     */
+    virtual bool preempts(int pid, int running) const;
+
+    /**
+     * @param core : core index
+     * @return : number of processes ready on the core
+     */
+    virtual std::size_t size(int core) const = 0;
+
+    /**
+     * @param core : core index
+     * @return : pids ready on the core, in the order they would run if nothing changed
+     */
+    virtual std::deque<int> toDeque(int core) const = 0;
+
+    /**
+     * @param core : core index
+     * @return : true if nothing is ready on the core
+     */
+    bool empty(int core) const;
+
+    /**
+     * @param pid : process pid
+     * @param priority : 0 is the highest, PRIORITY_LEVELS - 1 the lowest
+     */
+    void setPriority(int pid, int priority);
+
+    /**
+     * @param pid : process pid
+     * @return : its priority, DEFAULT_PRIORITY if none was set
+     */
+    int getPriority(int pid) const;
+};
+
+/**
+ * Creates a scheduler
+ * @param type : scheduler to create
+ * @param cores : number of cores
+ * @return : the new scheduler
+ */
+std::unique_ptr<Scheduler> makeScheduler(SchedulerType type, int cores);
+
+#endif // SCHEDULER_HPP_
@@ -0,0 +1,192 @@
+// Raed Abuzaid
+
+#ifndef SCHEDULERS_HPP_
+#define SCHEDULERS_HPP_
+
+#include <cstdint>
+#include <vector>
+#include "ReadyQueue.hpp"
+#include "Scheduler.hpp"
+
+/**
+ * Plain round robin, one FIFO queue per core
+ */
+class RoundRobinScheduler : public Scheduler
+{
+private:
+    ReadyQueue queues_; // one per core
+
+public:
+    /**
+     * @param cores : number of cores
+     */
+    RoundRobinScheduler(int cores);
+
+    void enqueue(int pid, int core, ReadyReason reason) override;
+    int pickNext(int core) override;
+    int steal(int core) override;
+    void remove(int pid) override;
+    std::size_t size(int core) const override;
+    std::deque<int> toDeque(int core) const override;
+};
+
+/**
+ * A FIFO bucket per level and core, with a bitmap per core of the buckets that are not empty.
+ * The best ready process is the front of the bucket of the lowest set bit, so picking one is a
+ * bit scan; stealing takes the back of the worst non-empty bucket. Subclasses decide the level.
+ */
+class BucketScheduler : public Scheduler
+{
+private:
+    int levelCount_;
+    ReadyQueue buckets_;                 // bucket core * levelCount_ + level
+    std::vector<std::uint64_t> bitmaps_; // per core, bit l set if bucket l is not empty
+    std::vector<std::size_t> sizes_;     // per core
+
+    /**
+     * Queues a process in the bucket of its current level
+     * @param pid : process pid
+     * @param core : core index
+     * @param front : true to queue it ahead of its level, false behind
+     */
+    void link(int pid, int core, bool front);
+
+    /**
+     * Takes a process out of its bucket and keeps the bitmap in step
+     * @param pid : queued process pid, or one just popped from the bucket
+     * @param bucket : its bucket
+     */
+    void unlink(int pid, int bucket);
+
+    /**
+     * Called before a process is queued, so the level can follow its behaviour
+     * @param pid : process pid
+     * @param reason : why it became ready
+     */
+    virtual void onEnqueue(int pid, ReadyReason reason);
+
+    /**
+     * @param pid : process pid
+     * @return : its level, 0 runs first
+     */
+    virtual int level(int pid) const = 0;
+
+    void onPriorityChange(int pid) override;
+
+public:
+    /**
+     * @param cores : number of cores
+     * @param levels : number of levels, at most 64
+     */
+    BucketScheduler(int cores, int levels);
+
+    void enqueue(int pid, int core, ReadyReason reason) override;
+    int pickNext(int core) override;
+    int steal(int core) override;
+    void remove(int pid) override;
+    bool preempts(int pid, int running) const override;
+    std::size_t size(int core) const override;
+    std::deque<int> toDeque(int core) const override;
+};
+
+/**
+ * Strict priority, round robin among equal priorities.
+ * A process that becomes ready with a higher priority than the running one takes its core.
+ */
+class PriorityScheduler : public BucketScheduler
+{
+private:
+    int level(int pid) const override;
+
+public:
+    /**
+     * @param cores : number of cores
+     */
+    PriorityScheduler(int cores);
+};
+
+/**
+ * Multi-level feedback queue.
+ * Processes start on the top level, drop one level every time their slice runs out and go back
+ * to the top when a disk read or wait completes, so I/O bound processes stay ahead of CPU bound ones.
+ */
+class MLFQScheduler : public BucketScheduler
+{
+private:
+    std::vector<int> levels_; // per pid
+
+    void onEnqueue(int pid, ReadyReason reason) override;
+    int level(int pid) const override;
+
+public:
+    /**
+     * @param cores : number of cores
+     */
+    MLFQScheduler(int cores);
+};
+
+/**
+ * Completely fair style scheduling.
+ * Every process accumulates virtual runtime, one time slice scaled down by its priority's weight
+ * per timer interrupt, and each core runs the ready process with the least. Ready processes of a
+ * core sit in a binary min-heap with their position recorded per pid, so pick and removal are
+ * O(log n); stealing takes the last leaf, which never needs a sift. A process keeps its lead or
+ * lag over the core's minimum when it moves to another core.
+ */
+class FairScheduler : public Scheduler
+{
+private:
+    std::vector<std::vector<int>> heaps_;     // per core, pids ordered by (virtual runtime, arrival)
+    std::vector<long long> minRuntime_;       // per core, never decreases
+    std::vector<long long> runtime_;          // per pid, virtual runtime
+    std::vector<long long> lag_;              // per pid, runtime past its core's minimum when it left the queue
+    std::vector<unsigned long long> arrival_; // per pid, breaks ties in queueing order
+    std::vector<int> heapCore_;               // per pid, core whose heap holds it, -1 if it is not queued
+    std::vector<std::size_t> heapIndex_;      // per pid, position in that heap
+    unsigned long long arrivals_;
+
+    /**
+     * @param a : process pid
+     * @param b : process pid
+     * @return : true if a runs before b
+     */
+    bool before(int a, int b) const;
+
+    /**
+     * Puts a pid at a heap position and records it
+     * @param core : core index
+     * @param index : heap position
+     * @param pid : process pid
+     */
+    void place(int core, std::size_t index, int pid);
+
+    /**
+     * Moves the pid at a heap position up or down until the heap is ordered again
+     * @param core : core index
+     * @param index : heap position
+     */
+    void sift(int core, std::size_t index);
+
+    /**
+     * Removes the pid at a heap position and records how far it was past the core's minimum
+     * @param core : core index
+     * @param index : heap position
+     * @return : its pid
+     */
+    int take(int core, std::size_t index);
+
+public:
+    /**
+     * @param cores : number of cores
+     */
+    FairScheduler(int cores);
+
+    void enqueue(int pid, int core, ReadyReason reason) override;
+    int pickNext(int core) override;
+    int steal(int core) override;
+    void remove(int pid) override;
+    std::size_t size(int core) const override;
+    std::deque<int> toDeque(int core) const override;
+};
+
+#endif // SCHEDULERS_HPP_
@@ -4,8 +4,11 @@
 #ifndef SIM_OS_H_
 #define SIM_OS_H_
 
+#include <cstddef>
 #include <deque>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -13,6 +16,9 @@
 #include "DiskManager.hpp"
 #include "MemoryManager.hpp"
 #include "CPU.hpp"
+#include "EventQueue.hpp"
+#include "SimOSOptions.hpp"
+#include "TraceRecorder.hpp"
 
 class SimOS
 {
@@ -21,6 +27,39 @@ private:
     DiskManager diskManager_;
     MemoryManager memoryManager_;
     CPU cpu_;
+    EventQueue events_;
+    unsigned long long now_;                            // virtual time
+    unsigned long long quantum_;
+    std::vector<unsigned long long> timerStamps_;       // per core, dispatch count its pending timer belongs to
+    std::vector<unsigned long long> diskStamps_;        // per disk, started count when its slots were last scheduled
+    std::vector<std::function<void(SimOS &)>> actions_; // by action id, empty once run
+    std::vector<int> freeActions_;
+    std::unique_ptr<TraceRecorder> recorder_;           // only set when recording
+
+    /**
+     * Throws if the core does not exist
+     * @param core : core index
+     */
+    void checkCore(int core);
+
+    /**
+     * Returns processes a disk served to the ready-queue and fills idle cores
+     * @param pids : processes in the order they asked
+     */
+    void wakeProcesses(const std::vector<int> &pids);
+
+    /**
+     * Schedules a timer interrupt for every core that started a process, and a completion for every disk that
+     * started a request, since the last call
+     */
+    void scheduleEvents();
+
+    /**
+     * Carries out an event, unless what it was scheduled for has changed since
+     * @param event : the event
+     * @return : true if the event was still current
+     */
+    bool handleEvent(const Event &event);
 
 public:
     /**
@@ -29,8 +68,9 @@ public:
      * @param numberOfDisks : number of hard disks in the simulated computer.
      * @param amountOfRAM : amount of memory
      * @param pageSize : page size
+     * @param options : optional settings
      */
-    SimOS(int numberOfDisks, unsigned long long amountOfRAM, unsigned int pageSize);
+    SimOS(int numberOfDisks, unsigned long long amountOfRAM, unsigned int pageSize, SimOSOptions options = SimOSOptions());
 
     /**
      * Creates a new process and adds it to the ready queue. Every process in the simulated system has a PID.
@@ -40,9 +80,12 @@ public:
     void NewProcess();
 
     /**
-     * The currently running process forks a child. The child is placed in the end of the ready-queue.
+     * The currently running process forks a child. The child is placed in the end of the ready-queue of the least loaded core.
+     * With SimOSOptions::copyOnWriteFork the child shares every resident page of the parent until one of them writes it.
+     *
+     * @param core : core running the forking process.
      */
-    void SimFork();
+    void SimFork(int core = 0);
 
     /**
      * The process that is currently using the CPU terminates.
@@ -51,78 +94,234 @@ public:
      * If its parent hasn't called wait yet, the process turns into zombie.
      * To avoid the appearance of orphans, the system implements cascading termination.
      * Cascading termination means that if a process terminates, all its descendants terminate with it.
+     *
+     * @param core : core running the exiting process.
      */
-    void SimExit();
+    void SimExit(int core = 0);
 
     /**
      * The process wants to pause and wait for any of its child processes to terminate.
      * Once the wait is over, the process goes to the end of the ready-queue or the CPU.
      * If the zombie-child already exists, the process proceeds right away (keeps using the CPU) and the zombie-child disappears.
      * If more than one zombie-child exists, the system uses one of them (any!) to immediately resume the parent, while other zombies keep waiting for the next wait from the parent.
+     *
+     * @param core : core running the waiting process.
      */
-    void SimWait();
+    void SimWait(int core = 0);
 
     /**
-     * Interrupt arrives from the timer signaling that the time slice of the currently running process is over.
+     * Interrupt arrives from the timer signaling that the time slice of the process running on a core is over.
+     *
+     * @param core : core whose timer fired.
      */
-    void TimerInterrupt();
+    void TimerInterrupt(int core = 0);
 
     /**
      * Currently running process requests to read the specified file from the disk with a given number.
      * The process issuing disk reading requests immediately stops using the CPU, even if the ready-queue is empty.
+     * If the file cache holds the file, the process goes back to the ready-queue instead of waiting for the disk.
      *
      * @param diskNumber : the number of the disk to read from.
      * @param fileName : the name of the file to read.
+     * @param core : core running the reading process.
      */
-    void DiskReadRequest(int diskNumber, std::string fileName);
+    void DiskReadRequest(int diskNumber, const std::string &fileName, int core = 0);
 
     /**
-     * A disk with a specified number reports that a single job is completed.
-     * The served process should return to the ready-queue.
+     * A disk with a specified number reports that a single job is completed, the oldest one if it serves several.
+     * The served process should return to the ready-queue, with every process whose read was coalesced into it, in the order they asked.
      *
      * @param diskNumber : the number of the disk that completed a job.
      */
     void DiskJobCompleted(int diskNumber);
 
+    /**
+     * A disk with a specified number reports that the job in one of its slots is completed, nothing happens if the slot is free.
+     * The served process should return to the ready-queue, with every process whose read was coalesced into it, in the order they asked.
+     *
+     * @param diskNumber : the number of the disk that completed a job.
+     * @param slot : the slot of the job, below the queue depth of the disk.
+     */
+    void DiskJobCompleted(int diskNumber, int slot);
+
     /**
      * Currently running process wants to access the specified logical memory address.
      * System makes sure the corresponding page is loaded in the RAM.
      * If the corresponding page is already in the RAM, its “recently used” information is updated.
+     * A write to a page shared by copy-on-write fork first gives the process its own copy.
      *
      * @param address : the logical memory address to access.
+     * @param write : true if the process writes the address.
+     * @param core : core running the process, its TLB is used.
      */
-    void AccessMemoryAddress(unsigned long long address);
+    void AccessMemoryAddress(unsigned long long address, bool write = false, int core = 0);
 
     /**
-     * @return : GetCPU returns the PID of the process currently using the CPU.
-     *           If CPU is idle it returns NO_PROCESS.
+     * Currently running process accesses a sequence of logical memory addresses, in order.
+     * Same result as calling AccessMemoryAddress on each address, but page numbers are computed in one pass
+     * and back to back accesses to one page are applied together.
+     *
+     * @param addresses : the logical memory addresses to access.
+     * @param count : number of addresses.
+     * @param write : true if the process writes the addresses.
+     * @param core : core running the process, its TLB is used.
+     */
+    void AccessMemoryAddresses(const unsigned long long *addresses, std::size_t count, bool write = false,
+                               int core = 0);
+
+    /**
+     * @param addresses : the logical memory addresses to access, in order.
+     * @param write : true if the process writes the addresses.
+     * @param core : core running the process, its TLB is used.
+     */
+    void AccessMemoryAddresses(const std::vector<unsigned long long> &addresses, bool write = false, int core = 0);
+
+    /**
+     * @param core : core to query.
+     * @return : GetCPU returns the PID of the process currently using the core.
+     *           If the core is idle it returns NO_PROCESS.
+     */
+    int GetCPU(int core = 0);
+
+    /**
+     * @param core : core to query.
+     * @return : GetReadyQueue returns the std::deque with PIDs of processes in the ready-queue of the core, in the order the scheduler would run them.
      */
-    int GetCPU();
+    std::deque<int> GetReadyQueue(int core = 0);
 
     /**
-     * @return : GetReadyQueue returns the std::deque with PIDs of processes in the ready-queue where element in front corresponds start of the ready-queue.
+     * Changes the priority of a process, used by the priority and fair schedulers from their next decision on.
+     *
+     * @param pid : process to change.
+     * @param priority : 0 is the highest, PRIORITY_LEVELS - 1 the lowest, processes start at DEFAULT_PRIORITY.
      */
-    std::deque<int> GetReadyQueue();
+    void SetPriority(int pid, int priority);
+
+    /**
+     * @param core : core to query.
+     * @return : processes the core took from other cores' queues and processes it ran after they last ran elsewhere.
+     */
+    CoreStats GetCoreStats(int core);
 
     /**
      * @return : GetMemory returns MemoryUsage vector describing all currently used frames of RAM.
      *           Terminated “zombie” processes don’t use memory, so they don’t contribute to memory usage.
      *           MemoryItems appear in the MemoryUsage vector in the order they appear in memory (from low addresses to high).
+     *           A frame shared by copy-on-write fork appears once for every process mapping it, with the same frameNumber.
      */
     MemoryUsage GetMemory();
 
     /**
      * @param diskNumber : the number of the disk to query.
-     * @return : GetDisk returns an object with PID of the process served by specified disk and the name of the file read for that process.
+     * @return : GetDisk returns an object with PID of the process served by specified disk and the name of the file read for that process,
+     *           the oldest one if the disk serves several.
      *           If the disk is idle, GetDisk returns the default FileReadRequest object (with PID 0 and empty string in fileName).
      */
     FileReadRequest GetDisk(int diskNumber);
 
     /**
      * @param diskNumber : the number of the disk to query.
-     * @return : GetDiskQueue returns the I/O-queue of the specified disk starting from the “next to be served” process.
+     * @return : the request served in every slot of the disk, indexed by slot, PID 0 and empty fileName for free slots.
+     */
+    std::vector<FileReadRequest> GetDiskSlots(int diskNumber);
+
+    /**
+     * @param diskNumber : the number of the disk to query.
+     * @return : GetDiskQueue returns the I/O-queue of the specified disk starting from the “next to be served” process,
+     *           in the order the disk's head scheduler would serve it if nothing else arrived.
+     *           Processes whose reads were coalesced into the one being served come first.
      */
     std::deque<FileReadRequest> GetDiskQueue(int diskNumber);
+
+    /**
+     * Changes the head scheduling policy of a disk, waiting requests stay queued.
+     *
+     * @param diskNumber : the number of the disk to configure.
+     * @param scheduler : head scheduling policy.
+     */
+    void SetDiskScheduler(int diskNumber, DiskSchedulerType scheduler);
+
+    /**
+     * Places a file on a disk. Files never placed sit at a block derived from their name.
+     *
+     * @param diskNumber : the number of the disk holding the file.
+     * @param fileName : the name of the file.
+     * @param block : block the file starts at, below SimOSOptions::diskModel.blocks.
+     */
+    void PlaceFile(int diskNumber, const std::string &fileName, unsigned long long block);
+
+    /**
+     * @param diskNumber : the number of the disk to query.
+     * @return : requests served, blocks travelled by the head and summed request latency of the disk.
+     *           Average latency is totalLatency / served.
+     */
+    DiskStats GetDiskStats(int diskNumber);
+
+    /**
+     * Needs SimOSOptions::fileCacheCapacity.
+     * @return : reads served from the file cache, reads that went to a disk and cached files dropped.
+     */
+    FileCacheStats GetFileCacheStats();
+
+    /**
+     * @return : hit, miss and eviction counters of the page replacement policy.
+     */
+    ReplacementStats GetReplacementStats();
+
+    /**
+     * @return : hit, miss and invalidation counters of the TLB.
+     */
+    TLBStats GetTLBStats();
+
+    /**
+     * @return : pages shared by copy-on-write fork and copies made when a sharer wrote one.
+     */
+    CopyOnWriteStats GetCopyOnWriteStats();
+
+    /**
+     * Needs SimOSOptions::prefetchDepth.
+     * @return : pages prefetched, later used, evicted unused and held back under memory pressure.
+     *           Accuracy is useful / issued, coverage is useful / (useful + GetReplacementStats().misses).
+     */
+    PrefetchStats GetPrefetchStats();
+
+    /**
+     * Needs SimOSOptions::stackDistanceAnalysis.
+     * @param maxFrames : largest RAM size, in frames, to report.
+     * @return : LRU miss ratio of every access so far with 0, 1, ..., maxFrames frames of RAM, empty if analysis is off.
+     */
+    std::vector<double> GetMissRatioCurve(unsigned long long maxFrames);
+
+    /**
+     * Needs SimOSOptions::stackDistanceAnalysis.
+     * @param pid : process to report.
+     * @param maxFrames : largest RAM size, in frames, to report.
+     * @return : LRU miss ratio of the process with 0, 1, ..., maxFrames frames of RAM to itself, empty if analysis is off.
+     */
+    std::vector<double> GetProcessMissRatioCurve(int pid, unsigned long long maxFrames);
+
+    /**
+     * Runs the simulation on its own up to a virtual time.
+     * A process is interrupted after running SimOSOptions::quantum, a disk completes its request once the transfer time
+     * of its model has passed, and scheduled actions run when due. Events at the same time are handled in the order they
+     * were scheduled, so a run is the same every time for a given seed.
+     *
+     * @param time : virtual time to stop at, not before GetTime().
+     * @return : number of events handled.
+     */
+    unsigned long long RunUntil(unsigned long long time);
+
+    /**
+     * @param time : virtual time to run the action at, not before GetTime().
+     * @param action : called with this SimOS when due, it may make any call, ScheduleAction included.
+     * @post : The action runs during the RunUntil call that reaches its time.
+     */
+    void ScheduleAction(unsigned long long time, std::function<void(SimOS &)> action);
+
+    /**
+     * @return : current virtual time.
+     */
+    unsigned long long GetTime();
 };
 
 #endif // SIM_OS_H_
\ No newline at end of file
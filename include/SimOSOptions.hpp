@@ -0,0 +1,38 @@
+// Raed Abuzaid
+
+#ifndef SIM_OS_OPTIONS_HPP_
+#define SIM_OS_OPTIONS_HPP_
+
+#include <string>
+#include <vector>
+#include "DiskManager.hpp"
+#include "ReplacementPolicy.hpp"
+#include "Scheduler.hpp"
+
+/**
+ * Optional settings for a SimOS object, defaults match the plain simulator
+ */
+struct SimOSOptions
+{
+    ReplacementPolicyType replacementPolicy{ReplacementPolicyType::LRU}; // page replacement policy
+    unsigned int tlbSets{16};                                            // sets per TLB, 0 disables the TLB
+    unsigned int tlbWays{4};                                             // entries per TLB set
+    bool stackDistanceAnalysis{false};                                   // record LRU stack distances of every access
+    bool copyOnWriteFork{false};                                         // children share the parent's frames until a write
+    unsigned int prefetchDepth{0};                                       // pages loaded ahead of a sequential stream, 0 disables
+    unsigned int prefetchPressureDepth{1};                               // pages loaded ahead when that evicts resident pages
+    int cores{1};                                                        // CPU cores, each with its own ready queue and TLB
+    SchedulerType scheduler{SchedulerType::ROUND_ROBIN};                 // policy ordering every ready queue
+    DiskSchedulerType diskScheduler{DiskSchedulerType::FCFS};            // head scheduling policy of every disk
+    DiskModel diskModel;                                                 // disk size and seek timing
+    std::vector<DiskModel> diskModels;                                   // disk i uses diskModels[i] if there is one, diskModel otherwise
+    unsigned long long fileCacheCapacity{0};                             // files kept after a disk read them, 0 disables
+    ReplacementPolicyType fileCachePolicy{ReplacementPolicyType::LRU};   // file cache replacement policy
+    bool coalesceDiskReads{false};                                       // reads of a file already on its disk join that read
+    unsigned long long quantum{0};                                       // virtual time a process runs before RunUntil interrupts it, 0 for never
+    unsigned long long seed{0};                                          // seed of every random choice the simulation makes
+    std::string traceFile{""};                                           // calls are recorded here, empty disables; RunUntil's events as the TimerInterrupt and DiskJobCompleted calls they make, virtual time is not recorded
+    bool compressTrace{true};                                            // the recorded trace is block compressed
+};
+
+#endif // SIM_OS_OPTIONS_HPP_
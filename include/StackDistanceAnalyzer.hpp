@@ -0,0 +1,105 @@
+// Raed Abuzaid
+
+#ifndef STACK_DISTANCE_ANALYZER_HPP_
+#define STACK_DISTANCE_ANALYZER_HPP_
+
+#include <unordered_map>
+#include <vector>
+#include "PageTable.hpp"
+
+/**
+ * Mattson stack distance analysis of a page access trace.
+ * LRU has the inclusion property, so one pass that records how many distinct pages were touched
+ * between two accesses to the same page (its stack distance) gives the LRU miss count for every
+ * RAM size at once. Distances are counted with a Fenwick tree over access times that holds a 1 at
+ * the latest access of every page, so each access costs O(log n).
+ * A global stack models the shared RAM of MemoryManager, and every process also gets its own
+ * stack for the curve it would see with RAM to itself. Process teardown is not modelled.
+ */
+class StackDistanceAnalyzer
+{
+private:
+    struct Stack
+    {
+        std::vector<unsigned int> marks;         // Fenwick tree over access times, 1-based
+        unsigned long long time{0};              // time of the latest access
+        unsigned long long distinctPages{0};     // pages with a mark
+        unsigned long long coldMisses{0};        // first accesses, missed at any RAM size
+        unsigned long long accesses{0};
+        std::vector<unsigned long long> distances; // distances[d] = re-accesses at stack distance d
+        PageTable lastAccess;                    // (pid, page) -> time of latest access
+
+        // Default constructor
+        Stack() : marks(1, 0) {}
+    };
+
+    unsigned long long pageSize_;
+    Stack global_;
+    std::unordered_map<int, Stack> processes_;
+
+    /**
+     * Records an access on one stack
+     * @param stack : stack to update
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    static void record(Stack &stack, int pid, unsigned long long pageNumber);
+
+    /**
+     * Renumbers the marked access times 1..distinctPages so the tree stays proportional to the pages
+     * @param stack : stack to compact
+     */
+    static void compact(Stack &stack);
+
+    /**
+     * @param stack : stack to read
+     * @param maxFrames : largest RAM size, in frames, to report
+     * @return : miss ratio for every RAM size from 0 to maxFrames frames
+     */
+    static std::vector<double> curve(const Stack &stack, unsigned long long maxFrames);
+
+public:
+    /**
+     * @param pageSize : page size used to turn addresses into pages
+     */
+    StackDistanceAnalyzer(unsigned int pageSize);
+
+    /**
+     * Records an access by address
+     * @param pid : process pid
+     * @param address : process logical address
+     */
+    void accessAddress(int pid, unsigned long long address);
+
+    /**
+     * Records an access by page number
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    void accessPage(int pid, unsigned long long pageNumber);
+
+    /**
+     * @param maxFrames : largest RAM size, in frames, to report
+     * @return : global LRU miss ratio with 0, 1, ..., maxFrames frames of RAM
+     */
+    std::vector<double> missRatioCurve(unsigned long long maxFrames) const;
+
+    /**
+     * @param pid : process pid
+     * @param maxFrames : largest RAM size, in frames, to report
+     * @return : LRU miss ratio of the process alone with 0, 1, ..., maxFrames frames, empty if it never accessed memory
+     */
+    std::vector<double> missRatioCurve(int pid, unsigned long long maxFrames) const;
+
+    /**
+     * @return : number of frames past which the global miss ratio stops improving
+     */
+    unsigned long long maxUsefulFrames() const;
+
+    /**
+     * @return : number of recorded accesses
+     */
+    unsigned long long accesses() const;
+};
+
+#endif // STACK_DISTANCE_ANALYZER_HPP_
@@ -0,0 +1,94 @@
+// Raed Abuzaid
+
+#ifndef TLB_HPP_
+#define TLB_HPP_
+
+#include <vector>
+
+struct TLBStats
+{
+    unsigned long long hits{0};
+    unsigned long long misses{0};
+    unsigned long long invalidations{0}; // entries dropped because their page left RAM or their process terminated
+};
+
+/**
+ * Set-associative translation lookaside buffer caching (PID, page) -> frame.
+ * Entries are tagged with the PID (PIDs are never reused, so they double as ASIDs),
+ * which means a context switch needs no flush. Each set replaces its least recently used way.
+ */
+class TLB
+{
+private:
+    struct Entry
+    {
+        unsigned long long pageNumber{0};
+        unsigned long long frameNumber{0};
+        unsigned long long lastUse{0}; // 0 marks an invalid entry
+        int PID{0};
+    };
+
+    std::vector<Entry> entries_; // sets_ * ways_, one set after the other
+    unsigned long long setMask_;
+    unsigned int ways_;
+    unsigned long long clock_; // access stamp for LRU within a set
+    TLBStats stats_;
+
+    /**
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @return : first entry of the set the page maps to
+     */
+    Entry *set(int pid, unsigned long long pageNumber);
+
+public:
+    /**
+     * Creates an empty TLB, a TLB with no entries never hits and counts nothing
+     * @param sets : number of sets, rounded down to a power of two
+     * @param ways : entries per set
+     */
+    TLB(unsigned int sets, unsigned int ways);
+
+    /**
+     * Looks up a translation, counting a hit or a miss
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @param frameNumber : set to the cached frame on a hit
+     * @return : true on a hit
+     */
+    bool lookup(int pid, unsigned long long pageNumber, unsigned long long &frameNumber);
+
+    /**
+     * Counts hits on a translation that was just looked up, for repeated accesses to one page
+     * @param count : number of hits
+     */
+    void recordHits(unsigned long long count);
+
+    /**
+     * Caches a translation, replacing the least recently used way of its set
+     * @param pid : process pid
+     * @param pageNumber : page number
+     * @param frameNumber : frame number
+     */
+    void insert(int pid, unsigned long long pageNumber, unsigned long long frameNumber);
+
+    /**
+     * Drops the translation of a page if it is cached
+     * @param pid : process pid
+     * @param pageNumber : page number
+     */
+    void invalidate(int pid, unsigned long long pageNumber);
+
+    /**
+     * Drops every translation of a set of processes in one pass
+     * @param pids : true at the index of every process to drop
+     */
+    void invalidateProcesses(const std::vector<bool> &pids);
+
+    /**
+     * @return : hit, miss and invalidation counters
+     */
+    const TLBStats &stats() const;
+};
+
+#endif // TLB_HPP_
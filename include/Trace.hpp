@@ -0,0 +1,276 @@
+// Raed Abuzaid
+
+#ifndef TRACE_HPP_
+#define TRACE_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DiskScheduler.hpp"
+#include "SimOSOptions.hpp"
+
+/**
+ * Binary traces of SimOS calls.
+ * A trace starts with the magic bytes, the format version, its flags and the settings the SimOS was built
+ * with, its options included since version 3, then a table of file names. Each call follows as one opcode
+ * byte and its arguments as LEB128 varints, so most calls take two to four bytes and files are referred to
+ * by their index in the table. Files first seen after the header are added to the table by a FILE_NAME
+ * record ahead of the call using them. Since version 4 accesses come in runs by one core with one mode. The
+ * next address is predicted as the last one plus the last step taken twice in a row, so a lone jump does not
+ * break a strided stream. A streak of accesses at their predicted address is stored as a zero byte and the
+ * streak length less one. Any other address is stored as the zigzag difference from its prediction, in one
+ * byte as the difference plus 8 if that fits, otherwise as a byte counting the little endian bytes after it.
+ * A compressed trace holds its calls in blocks, each its raw size, its stored size and the LZ compressed
+ * bytes, or the raw bytes if compression did not help or was not tried; calls never straddle blocks.
+ */
+
+constexpr char TRACE_MAGIC[8] = {'S', 'I', 'M', 'O', 'S', 'T', 'R', 'C'};
+constexpr unsigned int TRACE_VERSION{4};
+constexpr unsigned int TRACE_COMPRESSED{1};                // flag, calls are stored in compressed blocks
+constexpr std::size_t MAX_TRACE_RECORD_BYTES{1 + 4 * 10}; // opcode and up to four 64 bit varints, names aside
+constexpr unsigned int MAX_TRACE_RUN{255};               // accesses in one ACCESS_RUN, its count is one byte
+constexpr std::size_t TRACE_BLOCK_BYTES{1 << 18};         // calls a writer buffers before writing a block
+
+enum class TraceOp : unsigned char
+{
+    NEW_PROCESS,        // no arguments
+    FORK,               // core
+    EXIT,               // core
+    WAIT,               // core
+    TIMER,              // core
+    DISK_READ,          // core, disk, file
+    DISK_DONE,          // disk, completes its oldest job
+    DISK_SLOT_DONE,     // disk, slot
+    ACCESS,             // core, address, write, versions 1 to 3
+    SET_PRIORITY,       // pid, priority
+    SET_DISK_SCHEDULER, // disk, scheduler
+    PLACE_FILE,         // disk, file, block
+    FILE_NAME,          // name length, name, takes the next index of the file table
+    ACCESS_RUN          // core, write, count byte, then count address differences, read as count ACCESS calls
+};
+
+constexpr unsigned char TRACE_OPS{14};
+
+/**
+ * One call, fields the op does not take are left at their defaults
+ */
+struct TraceRecord
+{
+    TraceOp op{TraceOp::NEW_PROCESS};
+    int core{0};
+    int disk{0};
+    int slot{0};
+    unsigned int file{0};          // index in TraceHeader::files
+    unsigned long long address{0};
+    bool write{false};
+    int pid{0};
+    int priority{0};
+    DiskSchedulerType scheduler{DiskSchedulerType::FCFS};
+    unsigned long long block{0};
+    const char *name{nullptr};     // FILE_NAME only, not owned
+    std::size_t nameLength{0};
+    unsigned int count{0};         // ACCESS_RUN only
+};
+
+/**
+ * Settings of the traced SimOS and the files its calls read
+ */
+struct TraceHeader
+{
+    unsigned int version{TRACE_VERSION};
+    unsigned int flags{0};
+    int disks{1};
+    unsigned long long amountOfRAM{0};
+    unsigned int pageSize{0};
+    SimOSOptions options; // traceFile and compressTrace aside, older versions only have cores
+    std::vector<std::string> files;
+};
+
+/**
+ * Encodes a call
+ * @param record : the call
+ * @param out : room for traceRecordBytes(record) bytes
+ * @return : bytes written
+ */
+std::size_t encodeTraceRecord(const TraceRecord &record, unsigned char *out);
+
+/**
+ * @param record : a call
+ * @return : most bytes its encoding can take
+ */
+std::size_t traceRecordBytes(const TraceRecord &record);
+
+/**
+ * Decodes a call, throws if the bytes are not a whole call
+ * @param in : first byte of the call
+ * @param end : end of the bytes available
+ * @param record : set to the call
+ * @return : first byte after the call
+ */
+const unsigned char *decodeTraceRecord(const unsigned char *in, const unsigned char *end, TraceRecord &record);
+
+/**
+ * @param header : trace settings and files
+ * @return : the header as it is stored at the start of a trace
+ */
+std::vector<unsigned char> encodeTraceHeader(const TraceHeader &header);
+
+/**
+ * Decodes the header at the start of a trace, throws if it is not one this version reads
+ * @param in : first byte of the trace
+ * @param end : end of the trace
+ * @param header : set to the header
+ * @return : first byte after the header
+ */
+const unsigned char *decodeTraceHeader(const unsigned char *in, const unsigned char *end, TraceHeader &header);
+
+/**
+ * Writes a trace through a fixed buffer, one block at a time.
+ * Accesses join the open run while their core and mode match, any other call closes it. A block compressed
+ * by less than an eighth leaves the next ones raw without trying, up to 32 of them when it keeps happening.
+ */
+class TraceWriter
+{
+private:
+    std::FILE *file_;
+    bool compress_;
+    std::vector<unsigned char> buffer_;
+    std::size_t used_;
+    std::vector<unsigned char> scratch_;
+    std::unordered_map<std::string, unsigned int> files_; // name -> index in the file table
+    std::size_t run_;                  // offset of the open run's count byte, NO_RUN if none
+    int runCore_;
+    bool runWrite_;
+    unsigned long long lastAddress_;   // address of the last access written
+    unsigned long long lastStep_;      // difference between the last two accesses
+    unsigned long long stride_;        // last difference taken twice in a row, predicts the next access
+    unsigned int streak_;              // accesses at their predicted address not written yet
+    unsigned int rawLeft_;             // blocks still kept raw without trying to compress them
+    unsigned int rawStretch_;          // blocks kept raw after the last one compression did not pay for
+
+    /**
+     * Makes room for bytes more, writing the buffered calls if they do not fit
+     * @param bytes : bytes about to be encoded
+     */
+    void reserve(std::size_t bytes);
+
+    /**
+     * Writes the buffered calls to the file
+     */
+    void flush();
+
+    /**
+     * Ends the open run, if any, with its pending streak
+     */
+    void closeRun();
+
+public:
+    /**
+     * Creates the file and writes the header, throws if the file cannot be created
+     * @param path : trace file
+     * @param header : settings and files of the trace, TRACE_COMPRESSED in its flags compresses it
+     */
+    TraceWriter(const std::string &path, const TraceHeader &header);
+
+    TraceWriter(const TraceWriter &) = delete;
+    TraceWriter &operator=(const TraceWriter &) = delete;
+
+    ~TraceWriter();
+
+    /**
+     * Appends a call
+     * @param record : the call, not ACCESS_RUN or FILE_NAME
+     */
+    void write(const TraceRecord &record);
+
+    /**
+     * Appends accesses by one core, as if each was written as an ACCESS call
+     * @param core : core making the accesses
+     * @param write : true for writes
+     * @param addresses : logical addresses, in order
+     * @param count : number of addresses
+     */
+    void writeAccesses(int core, bool write, const unsigned long long *addresses, std::size_t count);
+
+    /**
+     * @param name : file name
+     * @return : index of the name in the file table, added with a FILE_NAME record the first time it is seen
+     */
+    unsigned int file(const std::string &name);
+
+    /**
+     * Writes what is buffered and closes the file, later writes are dropped
+     */
+    void close();
+};
+
+/**
+ * Reads a trace mapped into memory, calls are decoded in place as they are read.
+ * Compressed blocks are expanded one at a time into a buffer kept for the whole trace, and runs
+ * of accesses are handed out one ACCESS call at a time.
+ */
+class TraceReader
+{
+private:
+    const unsigned char *data_;
+    std::size_t size_;
+    const unsigned char *ops_;       // first call, or first block
+    const unsigned char *nextBlock_; // block after the current one
+    const unsigned char *cursor_;    // next call
+    const unsigned char *end_;       // end of the current block
+    std::vector<unsigned char> block_;
+    std::size_t headerFiles_;        // files listed in the header itself
+    TraceHeader header_;
+    unsigned int runLeft_;           // accesses of the current run not read yet
+    int runCore_;
+    bool runWrite_;
+    unsigned long long lastAddress_; // address of the last access read
+    unsigned long long lastStep_;    // difference between the last two accesses
+    unsigned long long stride_;      // last difference taken twice in a row, predicts the next access
+    unsigned int streak_;            // accesses of the current streak not read yet
+
+    /**
+     * Moves to the next block of a compressed trace, throws if it is damaged
+     * @return : false at the end of the trace
+     */
+    bool loadBlock();
+
+public:
+    /**
+     * Maps the file and reads its header, throws if it cannot be opened or is not a trace
+     * @param path : trace file
+     */
+    explicit TraceReader(const std::string &path);
+
+    TraceReader(const TraceReader &) = delete;
+    TraceReader &operator=(const TraceReader &) = delete;
+
+    ~TraceReader();
+
+    /**
+     * @return : settings of the trace, and its files so far
+     */
+    const TraceHeader &header() const;
+
+    /**
+     * Reads the next call, FILE_NAME records are added to the file table and skipped, runs are read one
+     * ACCESS at a time. Throws if the trace ends inside one
+     * @param record : set to the call
+     * @return : false at the end of the trace
+     */
+    bool next(TraceRecord &record);
+
+    /**
+     * Goes back to the first call
+     */
+    void rewind();
+
+    /**
+     * @return : bytes of the trace file
+     */
+    std::size_t fileBytes() const;
+};
+
+#endif // TRACE_HPP_
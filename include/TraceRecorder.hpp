@@ -0,0 +1,135 @@
+// Raed Abuzaid
+
+#ifndef TRACE_RECORDER_HPP_
+#define TRACE_RECORDER_HPP_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Trace.hpp"
+
+/**
+ * Appends SimOS calls to a trace file as they are made.
+ * A call is only copied, as it was made, into one of two buffers. When it fills the buffers swap and a
+ * background thread hands the calls of the full one to a TraceWriter, which encodes, compresses and
+ * writes them, while calls go on into the other. The caller waits only if the thread is still writing
+ * the previous buffer.
+ */
+class TraceRecorder
+{
+private:
+    TraceWriter writer_; // flusher only once it runs
+    std::vector<unsigned char> buffers_[2];
+    int active_;       // buffer calls go into
+    std::size_t used_; // bytes of the active buffer
+
+    std::thread flusher_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool full_;              // the other buffer waits to be written, guarded by mutex_
+    std::size_t fullBytes_;  // bytes of it
+    bool stopping_;          // guarded by mutex_
+
+    /**
+     * Hands the active buffer to the flusher and switches to the other one
+     */
+    void swapBuffers();
+
+    /**
+     * Background thread, writes full buffers until stopped
+     */
+    void flushLoop();
+
+    /**
+     * Writes the calls copied into a full buffer
+     * @param calls : the buffer
+     * @param size : bytes of it
+     */
+    void writeBuffer(const unsigned char *calls, std::size_t size);
+
+    /**
+     * Copies a call into the active buffer
+     * @param record : the call
+     * @param fileName : file the call names, or nullptr
+     */
+    void record(const TraceRecord &record, const std::string *fileName = nullptr);
+
+public:
+    /**
+     * Creates the trace file and starts the flusher, throws if the file cannot be created
+     * @param path : trace file
+     * @param header : settings of the traced SimOS, TRACE_COMPRESSED in its flags compresses the calls
+     */
+    TraceRecorder(const std::string &path, const TraceHeader &header);
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    /**
+     * Writes every call recorded and closes the file
+     */
+    ~TraceRecorder();
+
+    /**
+     * Records a call taking a core, or NewProcess
+     * @param op : NEW_PROCESS, FORK, EXIT, WAIT or TIMER
+     * @param core : core passed
+     */
+    void recordCall(TraceOp op, int core);
+
+    /**
+     * @param core : core running the reading process
+     * @param disk : disk number
+     * @param fileName : file name
+     */
+    void recordDiskRead(int core, int disk, const std::string &fileName);
+
+    /**
+     * @param disk : disk number
+     */
+    void recordDiskDone(int disk);
+
+    /**
+     * @param disk : disk number
+     * @param slot : slot
+     */
+    void recordDiskDone(int disk, int slot);
+
+    /**
+     * @param core : core running the process
+     * @param address : logical address
+     * @param write : true for a write
+     */
+    void recordAccess(int core, unsigned long long address, bool write);
+
+    /**
+     * @param core : core running the process
+     * @param addresses : logical addresses, in order
+     * @param count : number of addresses
+     * @param write : true for writes
+     */
+    void recordAccesses(int core, const unsigned long long *addresses, std::size_t count, bool write);
+
+    /**
+     * @param pid : process changed
+     * @param priority : new priority
+     */
+    void recordPriority(int pid, int priority);
+
+    /**
+     * @param disk : disk number
+     * @param scheduler : new policy
+     */
+    void recordDiskScheduler(int disk, DiskSchedulerType scheduler);
+
+    /**
+     * @param disk : disk number
+     * @param fileName : file name
+     * @param block : block of the file
+     */
+    void recordPlaceFile(int disk, const std::string &fileName, unsigned long long block);
+};
+
+#endif // TRACE_RECORDER_HPP_
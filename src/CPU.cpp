@@ -1,73 +1,235 @@
-
 // Raed Abuzaid
 
 #include "CPU.hpp"
 
-// Default constructor
-CPU::CPU() : runningProcess_(NO_PROCESS) {}
+/**
+ * @param cores : number of cores
+ * @param scheduler : policy ordering the ready queues
+ */
+CPU::CPU(int cores, SchedulerType scheduler)
+    : runningProcesses_(cores, NO_PROCESS), scheduler_(makeScheduler(scheduler, cores)), stats_(cores) {}
+
+/**
+ * @param core : core index
+ * @return : running process plus queued processes of the core
+ */
+std::size_t CPU::load(int core) const
+{
+    return scheduler_->size(core) + (runningProcesses_[core] != NO_PROCESS ? 1 : 0);
+}
 
 /**
- * Starts a process
+ * Puts a process on a core and records a migration if it last ran elsewhere
+ * @param pid : process pid
+ * @param core : core index
  */
-void CPU::startProcess()
+void CPU::run(int pid, int core)
 {
-    if (!readyQueue_.empty())
+    runningProcesses_[core] = pid;
+
+    if (pid < 0)
     {
-        runningProcess_ = readyQueue_.front();
-        readyQueue_.pop_front();
+        return;
     }
+    stats_[core].dispatches++;
+
+    if (static_cast<std::size_t>(pid) >= lastCore_.size())
+    {
+        lastCore_.resize(pid + 1, -1);
+    }
+    if (lastCore_[pid] != -1 && lastCore_[pid] != core)
+    {
+        stats_[core].migrations++;
+    }
+    lastCore_[pid] = core;
 }
 
 /**
- * @param: process pid
- * Adds process to CPU Ready queue
+ * Starts the next process the scheduler picks for a core, stealing one from the busiest other core if it has none
+ * TLB entries are tagged with the PID, so switching processes needs no TLB flush
+ * @param core : core index
  */
-void CPU::addProcess(int pid)
+void CPU::startProcess(int core)
 {
-    readyQueue_.push_back(pid);
+    if (!scheduler_->empty(core))
+    {
+        run(scheduler_->pickNext(core), core);
+        return;
+    }
+
+    // work stealing, the scheduler gives up the process that would wait longest there
+    int victim = -1;
+    for (int other = 0; other < getNumberOfCores(); other++)
+    {
+        if (other != core && !scheduler_->empty(other) &&
+            (victim == -1 || scheduler_->size(other) > scheduler_->size(victim)))
+        {
+            victim = other;
+        }
+    }
+
+    if (victim != -1)
+    {
+        stats_[core].steals++;
+        run(scheduler_->steal(victim), core);
+    }
 }
 
 /**
- * Sets running process to no process
+ * Starts a process on every idle core that can find one
  */
-void CPU::removeRunningProcess()
+void CPU::startIdleCores()
 {
-    runningProcess_ = NO_PROCESS;
+    for (int core = 0; core < getNumberOfCores(); core++)
+    {
+        if (runningProcesses_[core] == NO_PROCESS)
+        {
+            startProcess(core);
+        }
+    }
 }
 
 /**
- * Handles TImer interrupt from OS by pussing running process to back of ready queue
- * STarting new process
+ * Adds process to the ready queue of the least loaded core, taking the core right away if the scheduler prefers it
+ * to the running process
+ * @param pid : process pid
+ * @param reason : why it became ready
  */
-void CPU::handleTimerInterrupt()
+void CPU::addProcess(int pid, ReadyReason reason)
 {
-    if (!readyQueue_.empty())
+    int target = 0;
+    for (int core = 1; core < getNumberOfCores(); core++)
+    {
+        if (load(core) < load(target))
+        {
+            target = core;
+        }
+    }
+
+    // stay on the core it last ran on if that is no busier
+    if (pid >= 0 && static_cast<std::size_t>(pid) < lastCore_.size() && lastCore_[pid] != -1 &&
+        load(lastCore_[pid]) == load(target))
+    {
+        target = lastCore_[pid];
+    }
+
+    scheduler_->enqueue(pid, target, reason);
+
+    int running = runningProcesses_[target];
+    if (running != NO_PROCESS && scheduler_->preempts(pid, running))
     {
-        readyQueue_.push_back(runningProcess_); // put process to back of ready queue
-        startProcess();
+        scheduler_->enqueue(running, target, ReadyReason::PREEMPTED);
+        startProcess(target);
     }
 }
 
 /**
- * @return: currently running process
+ * Sets running process of a core to no process
+ * @param core : core index
  */
-int CPU::getRunningProcess()
+void CPU::removeRunningProcess(int core)
 {
-    return runningProcess_;
+    runningProcesses_[core] = NO_PROCESS;
 }
 
 /**
- * @return: the ready queue
+ * Handles TImer interrupt from OS by handing the running process back to the scheduler
+ * STarting whichever process it picks, which may be the same one
+ * @param core : core index
  */
-std::deque<int> CPU::getReadyQueue()
+void CPU::handleTimerInterrupt(int core)
 {
-    return readyQueue_;
+    if (!scheduler_->empty(core))
+    {
+        int expired = runningProcesses_[core];
+        scheduler_->enqueue(expired, core, ReadyReason::EXPIRED); // slice is over
+
+        int next = scheduler_->pickNext(core);
+        if (next != expired)
+        {
+            run(next, core);
+        }
+    }
 }
 
 /**
- * Removed process from cpu ready queue
+ * @param core : core index
+ * @return: currently running process of the core
  */
-void CPU::removeFromReadyQueue(int pid)
+int CPU::getRunningProcess(int core)
 {
-    readyQueue_.erase(std::remove(readyQueue_.begin(), readyQueue_.end(), pid), readyQueue_.end());
-}
\ No newline at end of file
+    return runningProcesses_[core];
+}
+
+/**
+ * @param core : core index
+ * @return: the ready queue of the core
+ */
+std::deque<int> CPU::getReadyQueue(int core)
+{
+    return scheduler_->toDeque(core);
+}
+
+/**
+ * Takes a process off the CPU entirely, whether it is queued or running on some core
+ * @param pid : process pid
+ */
+void CPU::removeProcess(int pid)
+{
+    scheduler_->remove(pid);
+
+    for (int &running : runningProcesses_)
+    {
+        if (running == pid)
+        {
+            running = NO_PROCESS;
+        }
+    }
+}
+
+/**
+ * Takes a set of processes off the CPU entirely, checking each core once
+ * @param pids : the processes
+ * @param terminated : true at the index of every pid in pids
+ */
+void CPU::removeProcesses(const std::vector<int> &pids, const std::vector<bool> &terminated)
+{
+    for (int pid : pids)
+    {
+        scheduler_->remove(pid);
+    }
+
+    for (int &running : runningProcesses_)
+    {
+        if (running >= 0 && static_cast<std::size_t>(running) < terminated.size() && terminated[running])
+        {
+            running = NO_PROCESS;
+        }
+    }
+}
+
+/**
+ * @param pid : process pid
+ * @param priority : 0 is the highest, PRIORITY_LEVELS - 1 the lowest
+ */
+void CPU::setPriority(int pid, int priority)
+{
+    scheduler_->setPriority(pid, priority);
+}
+
+/**
+ * @return : number of cores
+ */
+int CPU::getNumberOfCores() const
+{
+    return static_cast<int>(runningProcesses_.size());
+}
+
+/**
+ * @param core : core index
+ * @return : migration and steal counters of the core
+ */
+const CoreStats &CPU::getCoreStats(int core) const
+{
+    return stats_[core];
+}
@@ -3,99 +3,497 @@
 #include "DiskManager.hpp"
 #include <algorithm>
 
-// Parametized constructor
-DiskManager::DiskManager(int numberOfDisks) : numberOfDisks_{numberOfDisks}
+namespace
+{
+    /**
+     * splitmix64, so delays come out the same on every platform for a seed
+     * @param state : generator state, advanced
+     * @return : next random number
+     */
+    unsigned long long nextRandom(unsigned long long &state)
+    {
+        unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+}
+
+/**
+ * @param numberOfDisks : number of disks
+ * @param scheduler : head scheduling policy of every disk
+ * @param models : geometry and timing, disk i uses models[i], or the default model if there are fewer
+ * @param seed : seed of the rotational delays
+ */
+DiskManager::DiskManager(int numberOfDisks, DiskSchedulerType scheduler, const std::vector<DiskModel> &models,
+                         unsigned long long seed)
+    : numberOfDisks_{numberOfDisks}, clock_(0), coalescing_(false)
 {
     for (int i = 0; i < numberOfDisks; i++)
     {
-        disks_[i].currentlyServing = FileReadRequest();
-        disks_[i].diskQueue_ = std::deque<FileReadRequest>();
+        DiskModel model = static_cast<std::size_t>(i) < models.size() ? models[i] : DiskModel();
+
+        // every disk draws from its own stream
+        unsigned long long diskSeed = seed + i;
+        disks_.push_back(Disk(makeDiskScheduler(scheduler, model.blocks), model, nextRandom(diskSeed)));
     }
 }
 
 /**
- * Creates a read request with given parameters sends to disk
- * @param : process pid
- * @param : requested disk number
- * @param : File name
+ * Records a new outstanding read at the front of its process chain, leading an operation of its own
+ * @param pid : process pid
+ * @param diskNumber : disk number
+ * @param file : interned file name
+ * @return : read id
  */
-void DiskManager::readRequest(int pid, int diskNumber, std::string fileName)
+unsigned long long DiskManager::trackRead(int pid, int diskNumber, FileId file)
 {
-    FileReadRequest request(pid, fileName);
-    Disk &disk = disks_[diskNumber];
+    unsigned long long read = reads_.size();
+    if (!freeReads_.empty())
+    {
+        read = freeReads_.back();
+        freeReads_.pop_back();
+    }
+    else
+    {
+        reads_.push_back(OutstandingRead());
+    }
 
-    if (disk.currentlyServing.PID == 0)
+    OutstandingRead &entry = reads_[read];
+    entry.PID = pid;
+    entry.diskNumber = diskNumber;
+    entry.file = file;
+    entry.serving = false;
+    entry.slot = NO_SLOT;
+    entry.leader = true;
+    entry.prevWaiter = read;
+    entry.nextWaiter = read;
+
+    if (static_cast<std::size_t>(pid) >= processReads_.size())
     {
-        disk.currentlyServing = request;
+        // pids grow one by one, so this only runs when a new process makes its first read
+        processReads_.resize(std::max(processReads_.size() * 2, static_cast<std::size_t>(pid) + 1), NO_READ);
+    }
+
+    entry.prevOfProcess = NO_READ;
+    entry.nextOfProcess = processReads_[pid];
+    if (entry.nextOfProcess != NO_READ)
+    {
+        reads_[entry.nextOfProcess].prevOfProcess = read;
+    }
+    processReads_[pid] = read;
+
+    return read;
+}
+
+/**
+ * Forgets an outstanding read
+ * @param read : read id
+ */
+void DiskManager::untrackRead(unsigned long long read)
+{
+    OutstandingRead &entry = reads_[read];
+
+    if (entry.nextOfProcess != NO_READ)
+    {
+        reads_[entry.nextOfProcess].prevOfProcess = entry.prevOfProcess;
+    }
+
+    if (entry.prevOfProcess != NO_READ)
+    {
+        reads_[entry.prevOfProcess].nextOfProcess = entry.nextOfProcess;
     }
     else
     {
-        disk.diskQueue_.push_back(request);
+        processReads_[entry.PID] = entry.nextOfProcess; // NO_READ after the last read of the process
     }
+
+    freeReads_.push_back(read);
 }
 
 /**
- * Disk Completes one process
- * @param diskNumber : Disk Number
- * @return : process served
+ * Moves the head to the next waiting requests of a disk and starts serving them, until every slot is busy
+ * or nothing is waiting
+ * @param disk : the disk
  */
-int DiskManager::completeJob(int diskNumber)
+void DiskManager::serveNext(Disk &disk)
 {
-    Disk &disk = disks_[diskNumber];
+    while (!disk.freeSlots.empty() && !disk.diskQueue_->empty())
+    {
+        int slot = disk.freeSlots.back();
+        disk.freeSlots.pop_back();
+
+        unsigned long long distance;
+        QueuedRead next = disk.diskQueue_->pop(disk.head, distance);
+
+        reads_[next.id].serving = true;
+        reads_[next.id].slot = slot;
+        disk.head = next.request.block;
+        disk.stats.headMovement += distance;
+        disk.stats.started++;
+
+        unsigned long long rotation =
+            disk.model.rotationTime == 0 ? 0 : nextRandom(disk.random) % disk.model.rotationTime;
+        disk.time = std::max(disk.time, clock_);
+
+        DiskSlot &serving = disk.slots[slot];
+        serving.serving = next.request;
+        serving.read = next.id;
+        serving.arrival = next.arrivalTime;
+        serving.finishTime = disk.time + disk.model.accessTime + disk.model.seekTime * distance + rotation;
+        serving.operation = disk.stats.started;
+
+        // newest in flight
+        serving.older = disk.newest;
+        serving.newer = NO_SLOT;
+        if (disk.newest != NO_SLOT)
+        {
+            disk.slots[disk.newest].newer = slot;
+        }
+        else
+        {
+            disk.oldest = slot;
+        }
+        disk.newest = slot;
+    }
+}
+
+/**
+ * Frees a busy slot
+ * @param disk : the disk
+ * @param slot : slot index
+ */
+void DiskManager::releaseSlot(Disk &disk, int slot)
+{
+    DiskSlot &freed = disk.slots[slot];
+
+    if (freed.older != NO_SLOT)
+    {
+        disk.slots[freed.older].newer = freed.newer;
+    }
+    else
+    {
+        disk.oldest = freed.newer;
+    }
+
+    if (freed.newer != NO_SLOT)
+    {
+        disk.slots[freed.newer].older = freed.older;
+    }
+    else
+    {
+        disk.newest = freed.older;
+    }
+
+    freed.serving = DiskRequest();
+    freed.read = NO_READ;
+    disk.freeSlots.push_back(slot);
+}
+
+/**
+ * Joins a read to the operation another read leads, behind every request already in it
+ * @param leader : read leading the operation
+ * @param read : read to attach
+ */
+void DiskManager::attachRead(unsigned long long leader, unsigned long long read)
+{
+    OutstandingRead &entry = reads_[read];
+    unsigned long long last = reads_[leader].prevWaiter;
+
+    entry.leader = false;
+    entry.prevWaiter = last;
+    entry.nextWaiter = leader;
+    reads_[last].nextWaiter = read;
+    reads_[leader].prevWaiter = read;
+}
+
+/**
+ * Takes a read out of its operation. The operation goes on for the others if it has any,
+ * otherwise it leaves the disk queue, or frees its slot if it was being served and
+ * records the disk in freedDisks_.
+ * @param read : read id
+ */
+void DiskManager::detachRead(unsigned long long read)
+{
+    OutstandingRead &entry = reads_[read];
+    Disk &disk = disks_[entry.diskNumber];
 
-    int servedProcess = disk.currentlyServing.PID;
-    disk.currentlyServing = FileReadRequest(0, "");
+    if (entry.nextWaiter == read)
+    {
+        clearPending(disk, entry.file, read);
 
-    if (!disk.diskQueue_.empty())
+        if (entry.serving)
+        {
+            // the disk gives up the transfer, the slot is refilled by the caller
+            releaseSlot(disk, entry.slot);
+            freedDisks_.push_back(entry.diskNumber);
+            untrackRead(read);
+        }
+        else
+        {
+            disk.diskQueue_->erase(entry.handle);
+            untrackRead(read);
+        }
+        return;
+    }
+
+    unsigned long long next = entry.nextWaiter;
+    reads_[entry.prevWaiter].nextWaiter = next;
+    reads_[next].prevWaiter = entry.prevWaiter;
+
+    if (entry.leader)
     {
-        disk.currentlyServing = disk.diskQueue_.front();
-        disk.diskQueue_.pop_front();
+        // the next request in line takes over the operation
+        OutstandingRead &successor = reads_[next];
+        successor.leader = true;
+        successor.serving = entry.serving;
+        successor.slot = entry.slot;
+        successor.handle = entry.handle;
+
+        if (entry.serving)
+        {
+            disk.slots[entry.slot].read = next;
+            disk.slots[entry.slot].serving.PID = successor.PID;
+        }
+        else
+        {
+            entry.handle->second.id = next;
+            entry.handle->second.request.PID = successor.PID;
+        }
+
+        if (entry.file < disk.pendingReads.size() && disk.pendingReads[entry.file] == read)
+        {
+            disk.pendingReads[entry.file] = next;
+        }
     }
 
-    return servedProcess;
+    untrackRead(read);
 }
 
 /**
- * Deletes requests of process from all disk without completing
+ * Stops a read from being the one later reads of its file join, if it is
+ * @param disk : disk of the read
+ * @param file : file the read is for
+ * @param read : read id
+ */
+void DiskManager::clearPending(Disk &disk, FileId file, unsigned long long read)
+{
+    if (file < disk.pendingReads.size() && disk.pendingReads[file] == read)
+    {
+        disk.pendingReads[file] = NO_READ;
+    }
+}
+
+/**
+ * Creates a read request with given parameters sends to disk, unless the file cache has the file
  * @param pid : process pid
+ * @param diskNumber : requested disk number
+ * @param fileName : File name
+ * @return : true if the read was served from the file cache and nothing was queued
  */
-void DiskManager::deleteRequests(int pid)
+bool DiskManager::readRequest(int pid, int diskNumber, const std::string &fileName)
 {
-    // Lambda function to check if a request's PID matches the param PID
-    auto isRequestedPID = [&](const FileReadRequest &request)
+    FileId file = fileNames_.intern(fileName);
+    if (fileCache_ && fileCache_->read(diskNumber, file))
+    {
+        return true;
+    }
+
+    Disk &disk = disks_[diskNumber];
+    unsigned long long read = trackRead(pid, diskNumber, file);
+
+    if (coalescing_)
+    {
+        if (file >= disk.pendingReads.size())
+        {
+            // ids are dense, so this only runs for a file this disk has not been asked for yet
+            disk.pendingReads.resize(std::max(disk.pendingReads.size() * 2, static_cast<std::size_t>(file) + 1),
+                                     NO_READ);
+        }
+
+        if (disk.pendingReads[file] != NO_READ)
+        {
+            attachRead(disk.pendingReads[file], read);
+            disk.stats.coalesced++;
+            return false;
+        }
+        disk.pendingReads[file] = read;
+    }
+
+    DiskRequest request(pid, file, getFileBlock(diskNumber, file));
+    reads_[read].handle = disk.diskQueue_->push(request, std::max(disk.time, clock_), read);
+    serveNext(disk);
+
+    return false;
+}
+
+/**
+ * Disk Completes the oldest operation it is serving
+ * @param diskNumber : Disk Number
+ * @return : processes served, in the order they asked, empty if the disk was idle
+ */
+const std::vector<int> &DiskManager::completeJob(int diskNumber)
+{
+    int oldest = disks_[diskNumber].oldest;
+    if (oldest == NO_SLOT)
+    {
+        completed_.clear();
+        return completed_;
+    }
+
+    return completeJob(diskNumber, oldest);
+}
+
+/**
+ * Disk Completes the operation in one slot
+ * @param diskNumber : Disk Number
+ * @param slot : slot below the queue depth of the disk
+ * @return : processes served, in the order they asked, empty if the slot was free
+ */
+const std::vector<int> &DiskManager::completeJob(int diskNumber, int slot)
+{
+    Disk &disk = disks_[diskNumber];
+    DiskSlot &done = disk.slots[slot];
+
+    completed_.clear();
+    if (done.serving.PID == 0)
+    {
+        return completed_;
+    }
+
+    unsigned long long leader = done.read;
+    unsigned long long read = leader;
+    do
+    {
+        unsigned long long next = reads_[read].nextWaiter;
+        completed_.push_back(reads_[read].PID);
+        untrackRead(read);
+        read = next;
+    } while (read != leader);
+
+    clearPending(disk, done.serving.file, leader);
+
+    disk.time = std::max(disk.time, done.finishTime);
+    disk.stats.served++;
+    disk.stats.totalLatency += done.finishTime - done.arrival;
+    if (fileCache_)
     {
-        return request.PID == pid;
-    };
+        fileCache_->fill(diskNumber, done.serving.file);
+    }
+
+    releaseSlot(disk, slot);
+    serveNext(disk);
+
+    return completed_;
+}
+
+/**
+ * Deletes requests of a set of processes from all disk without completing, including ones a disk is serving.
+ * Only the requests of those processes are visited, and the disks that lost a served request refill their
+ * slots once all of them are gone.
+ * @param pids : the processes
+ */
+void DiskManager::deleteRequests(const std::vector<int> &pids)
+{
+    freedDisks_.clear();
 
-    // Iterate over each disk's queue and remove requests with the PID
-    for (auto &disk : disks_)
+    for (int pid : pids)
     {
-        auto &diskQueue = disk.second.diskQueue_;
+        unsigned long long read =
+            pid >= 0 && static_cast<std::size_t>(pid) < processReads_.size() ? processReads_[pid] : NO_READ;
+
+        while (read != NO_READ)
+        {
+            unsigned long long nextRead = reads_[read].nextOfProcess;
 
-        // Move requests with the PID to the end of the queue
-        auto newEnd = std::remove_if(diskQueue.begin(), diskQueue.end(), isRequestedPID);
+            disks_[reads_[read].diskNumber].stats.cancelled++;
+            detachRead(read);
 
-        // Erase requests with the PID from the disk queue
-        diskQueue.erase(newEnd, diskQueue.end());
+            read = nextRead;
+        }
+    }
+
+    // no request of the set can be picked up any more; a disk that only lost waiting requests
+    // had every slot busy or nothing left to start, so it has nothing to refill
+    for (int diskNumber : freedDisks_)
+    {
+        serveNext(disks_[diskNumber]);
     }
 }
 
 /**
  * @param diskNumber : disk number
- * @return : request at front of disk, else empy request
+ * @return : oldest request the disk is serving, else empy request
  */
 FileReadRequest DiskManager::getDiskStatus(int diskNumber)
 {
-    return disks_[diskNumber].currentlyServing;
+    int oldest = disks_[diskNumber].oldest;
+    return oldest == NO_SLOT ? FileReadRequest(0, "") : getDiskStatus(diskNumber, oldest);
+}
+
+/**
+ * @param diskNumber : disk number
+ * @param slot : slot below the queue depth of the disk
+ * @return : request served in the slot, else empty request
+ */
+FileReadRequest DiskManager::getDiskStatus(int diskNumber, int slot)
+{
+    const DiskRequest &serving = disks_[diskNumber].slots[slot].serving;
+    return FileReadRequest(serving.PID, fileNames_.name(serving.file), serving.block);
 }
 
 /**
  * @param diskNumber : disk number
- * @return : return queue of requested disk number
+ * @param slot : slot below the queue depth of the disk
+ * @return : the slot
+ */
+const DiskSlot &DiskManager::getSlot(int diskNumber, int slot) const
+{
+    return disks_[diskNumber].slots[slot];
+}
+
+/**
+ * @param diskNumber : disk number
+ * @return : number of slots of the disk
+ */
+int DiskManager::getQueueDepth(int diskNumber) const
+{
+    return static_cast<int>(disks_[diskNumber].slots.size());
+}
+
+/**
+ * @param diskNumber : disk number
+ * @return : return queue of requested disk number, in the order it would be served.
+ *           Requests attached to those being served come first, each queued request is followed by those attached to it.
  */
 std::deque<FileReadRequest> DiskManager::getDiskQueue(int diskNumber)
 {
-    return disks_[diskNumber].diskQueue_;
+    const Disk &disk = disks_[diskNumber];
+    std::deque<FileReadRequest> requests;
+
+    for (int slot = disk.oldest; slot != NO_SLOT; slot = disk.slots[slot].newer)
+    {
+        const DiskSlot &inFlight = disk.slots[slot];
+        for (unsigned long long read = reads_[inFlight.read].nextWaiter; read != inFlight.read;
+             read = reads_[read].nextWaiter)
+        {
+            requests.push_back(
+                FileReadRequest(reads_[read].PID, fileNames_.name(inFlight.serving.file), inFlight.serving.block));
+        }
+    }
+
+    for (const QueuedRead &waiting : disk.diskQueue_->toDeque(disk.head))
+    {
+        const DiskRequest &request = waiting.request;
+        unsigned long long read = waiting.id;
+        do
+        {
+            requests.push_back(FileReadRequest(reads_[read].PID, fileNames_.name(request.file), request.block));
+            read = reads_[read].nextWaiter;
+        } while (read != waiting.id);
+    }
+
+    return requests;
 }
 
 /**
@@ -104,4 +502,115 @@ std::deque<FileReadRequest> DiskManager::getDiskQueue(int diskNumber)
 int DiskManager::getNumberOfDisks()
 {
     return numberOfDisks_;
-}
\ No newline at end of file
+}
+
+/**
+ * Changes the head scheduling policy of a disk, waiting requests keep their arrival order
+ * @param diskNumber : disk number
+ * @param scheduler : new policy
+ */
+void DiskManager::setScheduler(int diskNumber, DiskSchedulerType scheduler)
+{
+    Disk &disk = disks_[diskNumber];
+    std::unique_ptr<DiskScheduler> queue = makeDiskScheduler(scheduler, disk.model.blocks);
+
+    // the handles point into the old queue
+    for (const QueuedRead &waiting : disk.diskQueue_->drain())
+    {
+        reads_[waiting.id].handle = queue->push(waiting.request, waiting.arrivalTime, waiting.id);
+    }
+    disk.diskQueue_ = std::move(queue);
+}
+
+/**
+ * Places a file at a block, later reads of it seek there
+ * @param diskNumber : disk number
+ * @param fileName : file name
+ * @param block : block below blocks of the disk's model
+ */
+void DiskManager::placeFile(int diskNumber, const std::string &fileName, unsigned long long block)
+{
+    disks_[diskNumber].files[fileNames_.intern(fileName)] = block;
+}
+
+/**
+ * @param diskNumber : disk number
+ * @param file : interned file name
+ * @return : block of the file, files never placed get a fixed block derived from their name
+ */
+unsigned long long DiskManager::getFileBlock(int diskNumber, FileId file) const
+{
+    const Disk &disk = disks_[diskNumber];
+
+    auto placed = disk.files.find(file);
+    if (placed != disk.files.end())
+    {
+        return placed->second;
+    }
+
+    return disk.model.blocks == 0 ? 0 : fileNames_.hash(file) % disk.model.blocks;
+}
+
+/**
+ * @param diskNumber : disk number
+ * @return : served requests, head movement and latency of the disk
+ */
+const DiskStats &DiskManager::getDiskStats(int diskNumber) const
+{
+    return disks_[diskNumber].stats;
+}
+
+/**
+ * @param diskNumber : disk number
+ * @return : geometry and timing of the disk
+ */
+const DiskModel &DiskManager::getDiskModel(int diskNumber) const
+{
+    return disks_[diskNumber].model;
+}
+
+/**
+ * Moves virtual time forward, requests reaching an idle disk from now on start no earlier
+ * @param now : current virtual time
+ */
+void DiskManager::advanceClock(unsigned long long now)
+{
+    clock_ = std::max(clock_, now);
+}
+
+/**
+ * @return : names of every file read or placed so far
+ */
+const FileNameTable &DiskManager::getFileNames() const
+{
+    return fileNames_;
+}
+
+/**
+ * Starts caching the files disks finish reading, from now on
+ * @param capacity : number of files kept, 0 leaves caching off
+ * @param policy : policy choosing which file to drop
+ */
+void DiskManager::enableFileCache(unsigned long long capacity, ReplacementPolicyType policy)
+{
+    if (!fileCache_ && capacity > 0)
+    {
+        fileCache_.reset(new FileCache(capacity, policy));
+    }
+}
+
+/**
+ * @return : file cache counters, all zero if caching is off
+ */
+FileCacheStats DiskManager::getFileCacheStats() const
+{
+    return fileCache_ ? fileCache_->stats() : FileCacheStats();
+}
+
+/**
+ * Makes a read of a file already waiting for or being served by its disk join that read, from now on
+ */
+void DiskManager::enableCoalescing()
+{
+    coalescing_ = true;
+}
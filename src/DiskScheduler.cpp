@@ -0,0 +1,138 @@
+// Raed Abuzaid
+
+#include "DiskScheduler.hpp"
+#include "DiskSchedulers.hpp"
+#include <algorithm>
+
+DiskScheduler::DiskScheduler() : queue_(Queue::allocator_type(&nodes_)), arrivals_(0), up_(true) {}
+
+/**
+ * @param request : a request
+ * @return : the first half of its key in the queue
+ */
+unsigned long long DiskScheduler::positionKey(const DiskRequest &request) const
+{
+    return request.block;
+}
+
+/**
+ * Adds a request
+ * @param request : the request
+ * @param arrivalTime : disk time it was made
+ * @param id : the caller's handle for the request, handed back by pop
+ * @return : handle to cancel it with while it waits
+ */
+DiskScheduler::Handle DiskScheduler::push(const DiskRequest &request, unsigned long long arrivalTime,
+                                          unsigned long long id)
+{
+    QueuedRead read{request, arrivalTime, id};
+    return queue_.emplace(std::make_pair(positionKey(request), arrivals_++), read).first;
+}
+
+/**
+ * Removes the request to serve next, the queue must not be empty
+ * @param head : block under the head
+ * @param distance : set to the blocks the head travels to reach it
+ * @return : the request
+ */
+QueuedRead DiskScheduler::pop(unsigned long long head, unsigned long long &distance)
+{
+    Queue::const_iterator next = select(queue_, head, up_, distance);
+    QueuedRead read = next->second;
+    queue_.erase(next);
+
+    return read;
+}
+
+/**
+ * Removes a waiting request
+ * @param handle : handle push returned for it
+ */
+void DiskScheduler::erase(Handle handle)
+{
+    queue_.erase(handle);
+}
+
+/**
+ * Removes every waiting request
+ * @return : the requests in arrival order
+ */
+std::vector<QueuedRead> DiskScheduler::drain()
+{
+    std::vector<const Queue::value_type *> entries;
+    for (const Queue::value_type &entry : queue_)
+    {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Queue::value_type *a, const Queue::value_type *b)
+              { return a->first.second < b->first.second; });
+
+    std::vector<QueuedRead> reads;
+    for (const Queue::value_type *entry : entries)
+    {
+        reads.push_back(entry->second);
+    }
+    queue_.clear();
+
+    return reads;
+}
+
+/**
+ * @return : true if no request is waiting
+ */
+bool DiskScheduler::empty() const
+{
+    return queue_.empty();
+}
+
+/**
+ * @return : number of waiting requests
+ */
+std::size_t DiskScheduler::size() const
+{
+    return queue_.size();
+}
+
+/**
+ * @param head : block under the head
+ * @return : waiting requests in the order they would be served if nothing else arrived
+ */
+std::deque<QueuedRead> DiskScheduler::toDeque(unsigned long long head) const
+{
+    std::deque<QueuedRead> requests;
+    Queue remaining(queue_);
+    bool up = up_;
+    unsigned long long distance;
+
+    while (!remaining.empty())
+    {
+        Queue::const_iterator next = select(remaining, head, up, distance);
+        requests.push_back(next->second);
+        head = next->second.request.block;
+        remaining.erase(next);
+    }
+
+    return requests;
+}
+
+/**
+ * Creates a disk scheduler
+ * @param type : scheduler to create
+ * @param blocks : number of blocks on the disk
+ * @return : the new scheduler
+ */
+std::unique_ptr<DiskScheduler> makeDiskScheduler(DiskSchedulerType type, unsigned long long blocks)
+{
+    switch (type)
+    {
+    case DiskSchedulerType::SSTF:
+        return std::unique_ptr<DiskScheduler>(new SSTFDiskScheduler());
+    case DiskSchedulerType::SCAN:
+        return std::unique_ptr<DiskScheduler>(new SCANDiskScheduler(blocks));
+    case DiskSchedulerType::C_LOOK:
+        return std::unique_ptr<DiskScheduler>(new CLOOKDiskScheduler());
+    case DiskSchedulerType::FCFS:
+    default:
+        return std::unique_ptr<DiskScheduler>(new FCFSDiskScheduler());
+    }
+}
@@ -0,0 +1,133 @@
+// Raed Abuzaid
+
+#include "DiskSchedulers.hpp"
+#include <iterator>
+#include <limits>
+
+namespace
+{
+    /**
+     * @param from : block under the head
+     * @param to : target block
+     * @return : blocks between them
+     */
+    unsigned long long seek(unsigned long long from, unsigned long long to)
+    {
+        return from < to ? to - from : from - to;
+    }
+
+    /**
+     * @param queue : waiting requests
+     * @param head : block under the head
+     * @return : first request at or above the head, end if there is none
+     */
+    DiskScheduler::Queue::const_iterator atOrAbove(const DiskScheduler::Queue &queue, unsigned long long head)
+    {
+        return queue.lower_bound(std::make_pair(head, 0ULL));
+    }
+
+    /**
+     * @param queue : waiting requests
+     * @param head : block under the head
+     * @return : oldest request of the highest block at or below the head, end if there is none
+     */
+    DiskScheduler::Queue::const_iterator atOrBelow(const DiskScheduler::Queue &queue, unsigned long long head)
+    {
+        DiskScheduler::Queue::const_iterator above =
+            queue.upper_bound(std::make_pair(head, std::numeric_limits<unsigned long long>::max()));
+        if (above == queue.begin())
+        {
+            return queue.end();
+        }
+
+        // back to the first arrival on that block
+        DiskScheduler::Queue::const_iterator below = std::prev(above);
+        return queue.lower_bound(std::make_pair(below->first.first, 0ULL));
+    }
+}
+
+// FCFS
+
+unsigned long long FCFSDiskScheduler::positionKey(const DiskRequest &request) const
+{
+    return 0; // arrival order alone
+}
+
+DiskScheduler::Queue::const_iterator FCFSDiskScheduler::select(const Queue &queue, unsigned long long head, bool &up,
+                                                               unsigned long long &distance) const
+{
+    distance = seek(head, queue.begin()->second.request.block);
+    return queue.begin();
+}
+
+// SSTF
+
+DiskScheduler::Queue::const_iterator SSTFDiskScheduler::select(const Queue &queue, unsigned long long head, bool &up,
+                                                               unsigned long long &distance) const
+{
+    Queue::const_iterator above = atOrAbove(queue, head);
+    Queue::const_iterator below = atOrBelow(queue, head);
+
+    // ties go to the lower block
+    Queue::const_iterator next = above;
+    if (above == queue.end() ||
+        (below != queue.end() && seek(head, below->first.first) <= seek(head, above->first.first)))
+    {
+        next = below;
+    }
+
+    distance = seek(head, next->first.first);
+    return next;
+}
+
+// SCAN
+
+SCANDiskScheduler::SCANDiskScheduler(unsigned long long blocks) : lastBlock_(blocks == 0 ? 0 : blocks - 1) {}
+
+DiskScheduler::Queue::const_iterator SCANDiskScheduler::select(const Queue &queue, unsigned long long head, bool &up,
+                                                               unsigned long long &distance) const
+{
+    if (up)
+    {
+        Queue::const_iterator next = atOrAbove(queue, head);
+        if (next != queue.end())
+        {
+            distance = next->first.first - head;
+            return next;
+        }
+
+        // run to the last block, then sweep down to the highest request
+        up = false;
+        next = atOrBelow(queue, head);
+        distance = (lastBlock_ - head) + (lastBlock_ - next->first.first);
+        return next;
+    }
+
+    Queue::const_iterator next = atOrBelow(queue, head);
+    if (next != queue.end())
+    {
+        distance = head - next->first.first;
+        return next;
+    }
+
+    // run to block 0, then sweep up to the lowest request
+    up = true;
+    next = queue.begin();
+    distance = head + next->first.first;
+    return next;
+}
+
+// C-LOOK
+
+DiskScheduler::Queue::const_iterator CLOOKDiskScheduler::select(const Queue &queue, unsigned long long head, bool &up,
+                                                                unsigned long long &distance) const
+{
+    Queue::const_iterator next = atOrAbove(queue, head);
+    if (next == queue.end())
+    {
+        next = queue.begin(); // the return jump counts as head movement too
+    }
+
+    distance = seek(head, next->first.first);
+    return next;
+}
@@ -0,0 +1,132 @@
+// Raed Abuzaid
+
+#include "EventQueue.hpp"
+
+namespace
+{
+    constexpr std::size_t ARITY{4};
+}
+
+EventQueue::EventQueue() : sequence_(0) {}
+
+/**
+ * @param a : an event
+ * @param b : an event
+ * @return : true if a happens before b
+ */
+bool EventQueue::before(const Event &a, const Event &b)
+{
+    return a.time != b.time ? a.time < b.time : a.sequence < b.sequence;
+}
+
+/**
+ * Moves an event towards the root until its parent happens before it
+ * @param index : position in the heap
+ */
+void EventQueue::siftUp(std::size_t index)
+{
+    Event event = heap_[index];
+    while (index > 0)
+    {
+        std::size_t parent = (index - 1) / ARITY;
+        if (!before(event, heap_[parent]))
+        {
+            break;
+        }
+        heap_[index] = heap_[parent];
+        index = parent;
+    }
+    heap_[index] = event;
+}
+
+/**
+ * Moves an event towards the leaves until it happens before all its children
+ * @param index : position in the heap
+ */
+void EventQueue::siftDown(std::size_t index)
+{
+    Event event = heap_[index];
+    std::size_t size = heap_.size();
+
+    while (true)
+    {
+        std::size_t first = index * ARITY + 1;
+        if (first >= size)
+        {
+            break;
+        }
+
+        std::size_t last = first + ARITY < size ? first + ARITY : size;
+        std::size_t earliest = first;
+        for (std::size_t child = first + 1; child < last; child++)
+        {
+            if (before(heap_[child], heap_[earliest]))
+            {
+                earliest = child;
+            }
+        }
+
+        if (!before(heap_[earliest], event))
+        {
+            break;
+        }
+        heap_[index] = heap_[earliest];
+        index = earliest;
+    }
+    heap_[index] = event;
+}
+
+/**
+ * Schedules an event
+ * @param time : virtual time of the event
+ * @param type : kind of event
+ * @param target : core, disk or action id
+ * @param slot : slot of the disk, unused for other targets
+ * @param stamp : state of the target now
+ */
+void EventQueue::push(unsigned long long time, EventType type, int target, int slot, unsigned long long stamp)
+{
+    heap_.push_back(Event{time, sequence_++, type, target, slot, stamp});
+    siftUp(heap_.size() - 1);
+}
+
+/**
+ * @return : the earliest event, the queue must not be empty
+ */
+const Event &EventQueue::top() const
+{
+    return heap_.front();
+}
+
+/**
+ * Removes the earliest event, the queue must not be empty
+ * @return : the event
+ */
+Event EventQueue::pop()
+{
+    Event event = heap_.front();
+    heap_.front() = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty())
+    {
+        siftDown(0);
+    }
+
+    return event;
+}
+
+/**
+ * @return : true if no event is pending
+ */
+bool EventQueue::empty() const
+{
+    return heap_.empty();
+}
+
+/**
+ * @return : number of pending events, stale ones included
+ */
+std::size_t EventQueue::size() const
+{
+    return heap_.size();
+}
@@ -0,0 +1,94 @@
+// Raed Abuzaid
+
+#include "FileCache.hpp"
+
+namespace
+{
+    /**
+     * @param diskNumber : disk number
+     * @param file : interned file name
+     * @return : key of the file in the cache
+     */
+    unsigned long long cacheKey(int diskNumber, FileId file)
+    {
+        return (static_cast<unsigned long long>(diskNumber) << 32) | file;
+    }
+}
+
+/**
+ * @param capacity : number of files kept, at least 1
+ * @param policy : policy choosing which file to drop
+ */
+FileCache::FileCache(unsigned long long capacity, ReplacementPolicyType policy)
+    : capacity_(capacity), policy_(makeReplacementPolicy(policy, capacity))
+{
+    slots_.reserve(capacity);
+}
+
+/**
+ * Looks up a file for a read and counts the hit or miss
+ * @param diskNumber : disk number
+ * @param file : interned file name
+ * @return : true if the file is cached
+ */
+bool FileCache::read(int diskNumber, FileId file)
+{
+    auto cached = slots_.find(cacheKey(diskNumber, file));
+    if (cached == slots_.end())
+    {
+        stats_.misses++;
+        return false;
+    }
+
+    policy_->hit(cached->second);
+    stats_.hits++;
+    return true;
+}
+
+/**
+ * Caches a file a disk just read, dropping another one if the cache is full
+ * @param diskNumber : disk number
+ * @param file : interned file name
+ */
+void FileCache::fill(int diskNumber, FileId file)
+{
+    unsigned long long key = cacheKey(diskNumber, file);
+    if (slots_.count(key))
+    {
+        return; // another read of the same file finished first
+    }
+
+    policy_->miss(diskNumber, file);
+
+    unsigned long long slot = keys_.size();
+    if (keys_.size() < capacity_)
+    {
+        keys_.push_back(key);
+    }
+    else
+    {
+        slot = policy_->evict();
+        slots_.erase(keys_[slot]);
+        keys_[slot] = key;
+        stats_.evictions++;
+    }
+
+    slots_[key] = slot;
+    policy_->insert(slot, diskNumber, file);
+}
+
+/**
+ * @return : number of cached files
+ */
+unsigned long long FileCache::size() const
+{
+    return keys_.size();
+}
+
+/**
+ * @return : hit, miss and eviction counters
+ */
+const FileCacheStats &FileCache::stats() const
+{
+    return stats_;
+}
@@ -0,0 +1,72 @@
+// Raed Abuzaid
+
+#include "FileNameTable.hpp"
+
+namespace
+{
+    /**
+     * FNV-1a, so unplaced files land on the same block on every platform
+     * @param name : file name
+     * @return : hash of the name
+     */
+    unsigned long long hashName(const std::string &name)
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+        for (unsigned char c : name)
+        {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+FileNameTable::FileNameTable()
+{
+    intern(""); // takes NO_FILE
+}
+
+/**
+ * @param name : file name
+ * @return : id of the name, added to the table the first time it is seen
+ */
+FileId FileNameTable::intern(const std::string &name)
+{
+    auto found = ids_.find(name);
+    if (found != ids_.end())
+    {
+        return found->second;
+    }
+
+    FileId id = static_cast<FileId>(names_.size());
+    found = ids_.emplace(name, id).first;
+    names_.push_back(&found->first);
+    hashes_.push_back(hashName(name));
+
+    return id;
+}
+
+/**
+ * @param id : id returned by intern
+ * @return : the name
+ */
+const std::string &FileNameTable::name(FileId id) const
+{
+    return *names_[id];
+}
+
+/**
+ * @param id : id returned by intern
+ * @return : hash of the name, the same on every platform
+ */
+unsigned long long FileNameTable::hash(FileId id) const
+{
+    return hashes_[id];
+}
+
+/**
+ * @return : number of distinct names, the empty name included
+ */
+std::size_t FileNameTable::size() const
+{
+    return names_.size();
+}
@@ -0,0 +1,200 @@
+// Raed Abuzaid
+
+#include "FrameTable.hpp"
+
+/**
+ * Creates an empty frame table
+ * @param capacity : number of frames in RAM
+ */
+FrameTable::FrameTable(unsigned long long capacity) : capacity_(capacity), used_(0) {}
+
+/**
+ * Marks slot as free or occupied in the bitmap
+ * @param frame : frame number
+ * @param isFree : new state of the slot
+ */
+void FrameTable::setFree(unsigned long long frame, bool isFree)
+{
+    // size every level for the slot, the top level always ends up a single word
+    if (freeBits_.empty())
+    {
+        freeBits_.push_back(std::vector<unsigned long long>());
+    }
+
+    unsigned long long index = frame >> 6;
+    for (unsigned long long level = 0;; level++)
+    {
+        if (level == freeBits_.size())
+        {
+            // new top level, summarize the level below it
+            freeBits_.push_back(std::vector<unsigned long long>((freeBits_[level - 1].size() + 63) / 64, 0));
+            const std::vector<unsigned long long> &below = freeBits_[level - 1];
+            for (unsigned long long word = 0; word < below.size(); word++)
+            {
+                if (below[word] != 0)
+                {
+                    freeBits_[level][word >> 6] |= 1ULL << (word & 63);
+                }
+            }
+        }
+
+        std::vector<unsigned long long> &bits = freeBits_[level];
+        if (bits.size() <= index)
+        {
+            bits.resize(index + 1, 0);
+        }
+
+        if (bits.size() == 1 && level + 1 == freeBits_.size())
+        {
+            break;
+        }
+        index >>= 6;
+    }
+
+    // flip the slot bit and propagate only while a word changes between empty and non-empty
+    unsigned long long slot = frame;
+    for (unsigned long long level = 0; level < freeBits_.size(); level++)
+    {
+        unsigned long long &word = freeBits_[level][slot >> 6];
+        bool wasEmpty = word == 0;
+
+        if (isFree)
+        {
+            word |= 1ULL << (slot & 63);
+        }
+        else
+        {
+            word &= ~(1ULL << (slot & 63));
+        }
+
+        if (wasEmpty == (word == 0))
+        {
+            break;
+        }
+
+        isFree = word != 0;
+        slot >>= 6;
+    }
+}
+
+/**
+ * @return : lowest free slot below the high-water mark, NO_FRAME if there is none
+ */
+unsigned long long FrameTable::lowestFree() const
+{
+    if (freeBits_.empty() || freeBits_.back()[0] == 0)
+    {
+        return NO_FRAME;
+    }
+
+    unsigned long long index = 0;
+    for (unsigned long long level = freeBits_.size(); level-- > 0;)
+    {
+        index = (index << 6) + __builtin_ctzll(freeBits_[level][index]);
+    }
+
+    return index;
+}
+
+/**
+ * Places a page in the lowest free frame
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : frame number used, NO_FRAME if RAM is full
+ */
+unsigned long long FrameTable::allocate(int pid, unsigned long long pageNumber)
+{
+    if (full())
+    {
+        return NO_FRAME;
+    }
+
+    unsigned long long frame = lowestFree();
+    if (frame == NO_FRAME)
+    {
+        // no hole to reuse, take the next untouched slot
+        frame = frames_.size();
+        frames_.push_back(MemoryItem());
+    }
+    else
+    {
+        setFree(frame, false);
+    }
+
+    frames_[frame] = MemoryItem(pid, pageNumber, frame);
+    used_++;
+
+    return frame;
+}
+
+/**
+ * Frees an occupied frame
+ * @param frame : frame number
+ */
+void FrameTable::release(unsigned long long frame)
+{
+    frames_[frame] = MemoryItem();
+    setFree(frame, true);
+    used_--;
+}
+
+/**
+ * @param frame : frame number
+ * @return : the frame's memory item
+ */
+MemoryItem &FrameTable::operator[](unsigned long long frame)
+{
+    return frames_[frame];
+}
+
+/**
+ * @return : true if every frame is occupied
+ */
+bool FrameTable::full() const
+{
+    return used_ == capacity_;
+}
+
+/**
+ * @return : number of occupied frames
+ */
+unsigned long long FrameTable::used() const
+{
+    return used_;
+}
+
+/**
+ * @return : number of frames in RAM
+ */
+unsigned long long FrameTable::capacity() const
+{
+    return capacity_;
+}
+
+/**
+ * @return : occupied frames from low addresses to high
+ */
+MemoryUsage FrameTable::occupied() const
+{
+    MemoryUsage usage;
+    usage.reserve(used_);
+
+    for (unsigned long long base = 0; base < frames_.size(); base += 64)
+    {
+        // slots past the bitmap were never freed, so everything is occupied there
+        unsigned long long freeWord = freeBits_.empty() || (base >> 6) >= freeBits_[0].size() ? 0 : freeBits_[0][base >> 6];
+        unsigned long long occupiedWord = ~freeWord;
+        if (frames_.size() - base < 64)
+        {
+            occupiedWord &= (1ULL << (frames_.size() - base)) - 1;
+        }
+
+        while (occupiedWord != 0)
+        {
+            usage.push_back(frames_[base + __builtin_ctzll(occupiedWord)]);
+            occupiedWord &= occupiedWord - 1;
+        }
+    }
+
+    return usage;
+}
@@ -0,0 +1,145 @@
+// Raed Abuzaid
+
+#include "LRUList.hpp"
+
+namespace
+{
+    constexpr unsigned long long SENTINEL{0};
+}
+
+// Default constructor, slot 0 is the sentinel and frame f lives in slot f + 1
+LRUList::LRUList() : prev_(1, SENTINEL), next_(1, SENTINEL), size_(0) {}
+
+/**
+ * Grows the link arrays so that frame has a slot
+ * @param frame : frame number
+ */
+void LRUList::reserveFrame(unsigned long long frame)
+{
+    if (frame + 1 >= next_.size())
+    {
+        prev_.resize(frame + 2, NO_FRAME);
+        next_.resize(frame + 2, NO_FRAME);
+    }
+}
+
+/**
+ * Links a frame directly after the given slot
+ * @param slot : slot to link after
+ * @param frame : frame number
+ */
+void LRUList::linkAfter(unsigned long long slot, unsigned long long frame)
+{
+    unsigned long long self = frame + 1;
+    unsigned long long after = next_[slot];
+
+    prev_[self] = slot;
+    next_[self] = after;
+    next_[slot] = self;
+    prev_[after] = self;
+    size_++;
+}
+
+/**
+ * Marks frame as most recently used, linking it if it is not in the list yet
+ * @param frame : frame number
+ */
+void LRUList::touch(unsigned long long frame)
+{
+    reserveFrame(frame);
+
+    if (next_[SENTINEL] == frame + 1)
+    {
+        return; // already most recent
+    }
+
+    unlink(frame);
+    linkAfter(SENTINEL, frame);
+}
+
+/**
+ * Marks frame as least recently used, linking it if it is not in the list yet
+ * @param frame : frame number
+ */
+void LRUList::demote(unsigned long long frame)
+{
+    reserveFrame(frame);
+
+    if (prev_[SENTINEL] == frame + 1)
+    {
+        return; // already least recent
+    }
+
+    unlink(frame);
+    linkAfter(prev_[SENTINEL], frame);
+}
+
+/**
+ * Removes the least recently used frame from the list
+ * @return : evicted frame, NO_FRAME if list is empty
+ */
+unsigned long long LRUList::evict()
+{
+    if (size_ == 0)
+    {
+        return NO_FRAME;
+    }
+
+    unsigned long long frame = prev_[SENTINEL] - 1;
+    unlink(frame);
+
+    return frame;
+}
+
+/**
+ * Removes the least recently used frame other than keep, keep stays where it was
+ * @param keep : frame to pass over, NO_FRAME for none
+ * @return : evicted frame, NO_FRAME if no other frame is in the list
+ */
+unsigned long long LRUList::evictExcept(unsigned long long keep)
+{
+    unsigned long long frame = evict();
+    if (frame != NO_FRAME && frame == keep)
+    {
+        frame = evict();
+        demote(keep);
+    }
+
+    return frame;
+}
+
+/**
+ * Removes frame from the list, does nothing if frame is not linked
+ * @param frame : frame number
+ */
+void LRUList::unlink(unsigned long long frame)
+{
+    if (!contains(frame))
+    {
+        return;
+    }
+
+    unsigned long long self = frame + 1;
+    next_[prev_[self]] = next_[self];
+    prev_[next_[self]] = prev_[self];
+    prev_[self] = NO_FRAME;
+    next_[self] = NO_FRAME;
+    size_--;
+}
+
+/**
+ * @param frame : frame number
+ * @return : true if frame is in the list
+ */
+bool LRUList::contains(unsigned long long frame) const
+{
+    return frame + 1 < next_.size() && next_[frame + 1] != NO_FRAME;
+}
+
+/**
+ * @return : number of frames in the list
+ */
+unsigned long long LRUList::size() const
+{
+    return size_;
+}
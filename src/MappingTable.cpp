@@ -0,0 +1,207 @@
+// Raed Abuzaid
+
+#include "MappingTable.hpp"
+
+/**
+ * Appends a mapping to the sharer ring of a frame
+ * @param mapping : mapping id
+ * @param frame : frame number
+ */
+void MappingTable::linkSharer(unsigned long long mapping, unsigned long long frame)
+{
+    if (frame >= frameHeads_.size())
+    {
+        frameHeads_.resize(frame + 1, NO_MAPPING);
+        sharerCounts_.resize(frame + 1, 0);
+    }
+
+    Mapping &entry = mappings_[mapping];
+    entry.frameNumber = frame;
+
+    unsigned long long head = frameHeads_[frame];
+    if (head == NO_MAPPING)
+    {
+        entry.prevSharer = mapping;
+        entry.nextSharer = mapping;
+        frameHeads_[frame] = mapping;
+    }
+    else
+    {
+        // the newest sharer sits just before the head of the ring
+        unsigned long long tail = mappings_[head].prevSharer;
+        entry.prevSharer = tail;
+        entry.nextSharer = head;
+        mappings_[tail].nextSharer = mapping;
+        mappings_[head].prevSharer = mapping;
+    }
+
+    sharerCounts_[frame]++;
+}
+
+/**
+ * Takes a mapping out of the sharer ring of its frame
+ * @param mapping : mapping id
+ */
+void MappingTable::unlinkSharer(unsigned long long mapping)
+{
+    Mapping &entry = mappings_[mapping];
+    unsigned long long frame = entry.frameNumber;
+
+    if (entry.nextSharer == mapping)
+    {
+        frameHeads_[frame] = NO_MAPPING;
+    }
+    else
+    {
+        mappings_[entry.prevSharer].nextSharer = entry.nextSharer;
+        mappings_[entry.nextSharer].prevSharer = entry.prevSharer;
+        if (frameHeads_[frame] == mapping)
+        {
+            frameHeads_[frame] = entry.nextSharer;
+        }
+    }
+
+    sharerCounts_[frame]--;
+}
+
+/**
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : mapping id, NO_MAPPING if the page is not resident
+ */
+unsigned long long MappingTable::find(int pid, unsigned long long pageNumber) const
+{
+    const unsigned long long *mapping = index_.find(pid, pageNumber);
+
+    return mapping == nullptr ? NO_MAPPING : *mapping;
+}
+
+/**
+ * @param mapping : mapping id
+ * @return : the mapping
+ */
+const Mapping &MappingTable::operator[](unsigned long long mapping) const
+{
+    return mappings_[mapping];
+}
+
+/**
+ * Maps a page that is not resident yet to a frame
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @param frame : frame number
+ * @return : new mapping id
+ */
+unsigned long long MappingTable::map(int pid, unsigned long long pageNumber, unsigned long long frame)
+{
+    unsigned long long mapping = mappings_.size();
+    if (!freeMappings_.empty())
+    {
+        mapping = freeMappings_.back();
+        freeMappings_.pop_back();
+    }
+    else
+    {
+        mappings_.push_back(Mapping());
+    }
+
+    Mapping &entry = mappings_[mapping];
+    entry.PID = pid;
+    entry.pageNumber = pageNumber;
+
+    // push onto the front of the process chain
+    auto head = processHeads_.find(pid);
+    entry.prevInProcess = NO_MAPPING;
+    entry.nextInProcess = head == processHeads_.end() ? NO_MAPPING : head->second;
+    if (entry.nextInProcess != NO_MAPPING)
+    {
+        mappings_[entry.nextInProcess].prevInProcess = mapping;
+    }
+    processHeads_[pid] = mapping;
+
+    linkSharer(mapping, frame);
+    index_.insert(pid, pageNumber, mapping);
+
+    return mapping;
+}
+
+/**
+ * Removes a mapping from the index and both of its chains
+ * @param mapping : mapping id
+ */
+void MappingTable::unmap(unsigned long long mapping)
+{
+    Mapping &entry = mappings_[mapping];
+
+    index_.erase(entry.PID, entry.pageNumber);
+    unlinkSharer(mapping);
+
+    if (entry.nextInProcess != NO_MAPPING)
+    {
+        mappings_[entry.nextInProcess].prevInProcess = entry.prevInProcess;
+    }
+
+    if (entry.prevInProcess != NO_MAPPING)
+    {
+        mappings_[entry.prevInProcess].nextInProcess = entry.nextInProcess;
+    }
+    else if (entry.nextInProcess != NO_MAPPING)
+    {
+        processHeads_[entry.PID] = entry.nextInProcess;
+    }
+    else
+    {
+        processHeads_.erase(entry.PID); // last page of the process
+    }
+
+    freeMappings_.push_back(mapping);
+}
+
+/**
+ * @param pid : process pid
+ * @return : first mapping of the process, NO_MAPPING if it has none
+ */
+unsigned long long MappingTable::firstOfProcess(int pid) const
+{
+    auto head = processHeads_.find(pid);
+
+    return head == processHeads_.end() ? NO_MAPPING : head->second;
+}
+
+/**
+ * @param mapping : mapping id
+ * @return : next mapping of the same process, NO_MAPPING at the end
+ */
+unsigned long long MappingTable::nextOfProcess(unsigned long long mapping) const
+{
+    return mappings_[mapping].nextInProcess;
+}
+
+/**
+ * @param frame : frame number
+ * @return : oldest mapping of the frame, NO_MAPPING if it is not mapped
+ */
+unsigned long long MappingTable::firstSharer(unsigned long long frame) const
+{
+    return frame < frameHeads_.size() ? frameHeads_[frame] : NO_MAPPING;
+}
+
+/**
+ * @param mapping : mapping id
+ * @return : next mapping of the same frame, NO_MAPPING after the newest
+ */
+unsigned long long MappingTable::nextSharer(unsigned long long mapping) const
+{
+    unsigned long long next = mappings_[mapping].nextSharer;
+
+    return next == frameHeads_[mappings_[mapping].frameNumber] ? NO_MAPPING : next;
+}
+
+/**
+ * @param frame : frame number
+ * @return : number of mappings of the frame
+ */
+unsigned int MappingTable::sharers(unsigned long long frame) const
+{
+    return frame < sharerCounts_.size() ? sharerCounts_[frame] : 0;
+}
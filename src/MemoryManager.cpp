@@ -1,104 +1,525 @@
 // Raed Abuzaid
 
 #include "MemoryManager.hpp"
+#include <algorithm>
 #include <iostream>
 
-// Constructor
-MemoryManager::MemoryManager(unsigned long long amountOfRAM, unsigned int pageSize)
-    : pageSize_(pageSize), remainingMemory_(amountOfRAM / pageSize) {}
+namespace
+{
+    constexpr std::size_t BATCH_CHUNK{1024}; // addresses translated per pass of a batch
+}
 
 /**
- * Allocates memory for process
+ * Constructor
+ * @param amountOfRAM : amount of memory
+ * @param pageSize : page size
+ * @param policy : page replacement policy
+ * @param tlbSets : sets in each TLB, 0 disables the TLB
+ * @param tlbWays : entries per TLB set
+ * @param cores : number of CPU cores, each gets its own TLB
+ */
+MemoryManager::MemoryManager(unsigned long long amountOfRAM, unsigned int pageSize, ReplacementPolicyType policy,
+                             unsigned int tlbSets, unsigned int tlbWays, int cores)
+    : pageSize_(pageSize), policy_(makeReplacementPolicy(policy, amountOfRAM / pageSize)),
+      memory_(amountOfRAM / pageSize), tlbs_(std::max(cores, 1), TLB(tlbSets, tlbWays)), pageShift_(-1), pageBuffer_(BATCH_CHUNK),
+      copyOnWriteFork_(false), prefetchPending_(false)
+{
+    // power of two pages turn the division into a shift
+    if (pageSize != 0 && (pageSize & (pageSize - 1)) == 0)
+    {
+        pageShift_ = __builtin_ctz(pageSize);
+    }
+}
+
+/**
+ * Makes sure a page is in RAM and records the access
  * @param pid : process pid
- * @param address : process logical address
+ * @param pageNumber : page number
+ * @param write : true if the access writes the page
+ * @param core : core making the access
+ * @return : frame holding the page, NO_FRAME if RAM has no frames
  */
-void MemoryManager::accessAddress(int pid, unsigned long long address)
+unsigned long long MemoryManager::accessPage(int pid, unsigned long long pageNumber, bool write, int core)
 {
-    int pageNumber = address / pageSize_;
+    TLB &tlb = tlbs_[core];
+
+    // Recent translations skip the page table
+    unsigned long long cachedFrame;
+    if (tlb.lookup(pid, pageNumber, cachedFrame))
+    {
+        if (write && mappings_.sharers(cachedFrame) > 1)
+        {
+            return copyOnWrite(mappings_.find(pid, pageNumber), core);
+        }
+
+        policy_->hit(cachedFrame);
+        return cachedFrame;
+    }
 
     // Page table lookup
-    auto pageKey = std::make_pair(pid, pageNumber);
-    auto it = pageTable_.find(pageKey);
+    unsigned long long mapping = mappings_.find(pid, pageNumber);
 
     // Check if page is already in memory
-    if (it != pageTable_.end())
+    if (mapping != NO_MAPPING)
     {
+        unsigned long long frame = mappings_[mapping].frameNumber;
+        if (write && mappings_.sharers(frame) > 1)
+        {
+            return copyOnWrite(mapping, core);
+        }
+
         // If found, update the frame to recently used
-        unsigned long long frame = it->second;
-        frames_.remove(frame);
-        frames_.push_front(frame);
-        return;
+        tlb.insert(pid, pageNumber, frame);
+        policy_->hit(frame);
+
+        // a prefetched page reached, so its stream is still being followed
+        if (prefetcher_ && prefetcher_->accessed(frame))
+        {
+            prefetchPending_ = true;
+        }
+        return frame;
     }
 
-    // If memory is full, replace the least recently used frame
-    if (remainingMemory_ == 0)
+    // RAM without a single frame can't hold any page
+    if (memory_.capacity() == 0)
     {
-        unsigned long long frameToReplace = frames_.back();
-        frames_.pop_back();
+        return NO_FRAME;
+    }
+
+    policy_->miss(pid, pageNumber);
+
+    return loadPage(pid, pageNumber, core);
+}
+
+/**
+ * Releases the frame chosen by the replacement policy, unmapping it from every sharer
+ */
+void MemoryManager::evictVictim()
+{
+    unsigned long long frameToReplace = policy_->evict();
+
+    // Remove the old page from the page table and every TLB of each process sharing it
+    unsigned long long sharer = mappings_.firstSharer(frameToReplace);
+    while (sharer != NO_MAPPING)
+    {
+        unsigned long long nextSharer = mappings_.nextSharer(sharer);
+        unmapSharer(sharer);
+        sharer = nextSharer;
+    }
+
+    if (prefetcher_)
+    {
+        prefetcher_->released(frameToReplace);
+    }
+    memory_.release(frameToReplace);
+}
+
+/**
+ * Loads a page that was demanded but is not resident into a free frame, evicting a victim first if RAM is full
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @param core : core that faulted, its TLB caches the new translation
+ * @return : frame holding the page
+ */
+unsigned long long MemoryManager::loadPage(int pid, unsigned long long pageNumber, int core)
+{
+    // If memory is full, release the frame chosen by the replacement policy
+    if (memory_.full())
+    {
+        evictVictim();
+    }
+
+    // Place the page in the lowest free frame
+    unsigned long long frameNum = memory_.allocate(pid, pageNumber);
+
+    // Let the replacement policy track the new page
+    policy_->insert(frameNum, pid, pageNumber);
+
+    // add to page table
+    mappings_.map(pid, pageNumber, frameNum);
+    tlbs_[core].insert(pid, pageNumber, frameNum);
 
-        // Remove the old page entry from the page table
-        auto oldPageKey = std::make_pair(memory_[frameToReplace].PID, memory_[frameToReplace].pageNumber);
-        pageTable_.erase(oldPageKey);
+    // every demand fault may extend a stream
+    prefetchPending_ = prefetcher_ != nullptr;
 
-        // Update the memory frame with the new page
-        memory_[frameToReplace] = MemoryItem(pid, pageNumber, frameToReplace);
+    return frameNum;
+}
 
-        // Mark the frame as recently used
-        frames_.push_front(frameToReplace);
+/**
+ * Loads the pages the prefetcher proposes after a miss or a first access to a prefetched page
+ * @param pid : process pid
+ * @param pageNumber : page just accessed
+ * @param frame : frame holding that page, it stays resident
+ */
+void MemoryManager::prefetch(int pid, unsigned long long pageNumber, unsigned long long frame)
+{
+    prefetchPending_ = false;
+    unsigned long long freeFrames = memory_.capacity() - memory_.used();
+    prefetcher_->plan(pid, pageNumber, freeFrames, prefetchPages_);
 
-        // add to page table
-        pageTable_[pageKey] = frameToReplace;
+    // pages already resident need nothing
+    std::size_t count = 0;
+    for (unsigned long long page : prefetchPages_)
+    {
+        if (mappings_.find(pid, page) == NO_MAPPING)
+        {
+            prefetchPages_[count++] = page;
+        }
     }
-    else
+
+    // make room for the whole window first so it never evicts its own pages,
+    // the page that was just accessed is never the one to go
+    if (count > freeFrames)
     {
-        // If there is free memory, allocate a new frame
-        unsigned long long frameNum = memory_.size();
-        memory_.push_back(MemoryItem(pid, pageNumber, frameNum));
+        policy_->pin(frame);
+        for (unsigned long long i = freeFrames; i < count; i++)
+        {
+            evictVictim();
+        }
+        policy_->pin(NO_FRAME);
+    }
 
-        // Mark the new frame as recently used
-        frames_.push_front(frameNum);
-        remainingMemory_--;
+    // nearest page first, so the furthest one ends up with the lowest priority
+    for (std::size_t i = 0; i < count; i++)
+    {
+        unsigned long long prefetchFrame = memory_.allocate(pid, prefetchPages_[i]);
+        policy_->insertCold(prefetchFrame, pid, prefetchPages_[i]);
+        mappings_.map(pid, prefetchPages_[i], prefetchFrame);
+        prefetcher_->loaded(prefetchFrame);
+    }
+}
+
+/**
+ * Gives a writer its own copy of a shared page
+ * @param mapping : the writer's mapping of the shared frame
+ * @param core : core making the write
+ * @return : frame holding the private copy
+ */
+unsigned long long MemoryManager::copyOnWrite(unsigned long long mapping, int core)
+{
+    int pid = mappings_[mapping].PID;
+    unsigned long long pageNumber = mappings_[mapping].pageNumber;
 
-        // add to page table
-        pageTable_[pageKey] = frameNum;
+    // the other sharers keep the original frame, the write faults like a miss into a new one
+    unmapSharer(mapping);
+    copyOnWriteStats_.copies++;
+    policy_->miss(pid, pageNumber);
+
+    return loadPage(pid, pageNumber, core);
+}
+
+/**
+ * Removes one mapping of a frame, the frame itself stays allocated
+ * @param mapping : mapping id
+ */
+void MemoryManager::unmapSharer(unsigned long long mapping)
+{
+    const Mapping &entry = mappings_[mapping];
+    int pid = entry.PID;
+    unsigned long long pageNumber = entry.pageNumber;
+    unsigned long long frame = entry.frameNumber;
+
+    for (TLB &cpuTLB : tlbs_)
+    {
+        cpuTLB.invalidate(pid, pageNumber);
+    }
+    mappings_.unmap(mapping);
+    updateOwner(frame);
+}
+
+/**
+ * Reports a frame under its oldest remaining sharer
+ * @param frame : frame number
+ */
+void MemoryManager::updateOwner(unsigned long long frame)
+{
+    unsigned long long owner = mappings_.firstSharer(frame);
+    if (owner != NO_MAPPING)
+    {
+        memory_[frame].PID = mappings_[owner].PID;
+        memory_[frame].pageNumber = mappings_[owner].pageNumber;
     }
 }
 
 /**
- * Deallocates all memory associated with process pid
+ * Allocates memory for process
  * @param pid : process pid
+ * @param address : process logical address
+ * @param write : true if the access writes the page, breaking copy-on-write sharing
+ * @param core : core making the access, its TLB is used
  */
-void MemoryManager::deallocateMemory(int pid)
+void MemoryManager::accessAddress(int pid, unsigned long long address, bool write, int core)
 {
-    auto it = memory_.begin();
+    unsigned long long pageNumber = pageShift_ >= 0 ? address >> pageShift_ : address / pageSize_;
+
+    if (analyzer_)
+    {
+        analyzer_->accessPage(pid, pageNumber);
+    }
+    unsigned long long frame = accessPage(pid, pageNumber, write, core);
+
+    if (prefetchPending_)
+    {
+        prefetch(pid, pageNumber, frame);
+    }
+}
 
-    // Iterate through the memory items and remove those with the pid
-    while (it != memory_.end())
+/**
+ * Allocates memory for a run of accesses of one process, same result as calling accessAddress on each
+ * @param pid : process pid
+ * @param addresses : process logical addresses, in access order
+ * @param count : number of addresses
+ * @param write : true if the accesses write their pages
+ * @param core : core making the accesses, its TLB is used
+ */
+void MemoryManager::accessAddresses(int pid, const unsigned long long *addresses, std::size_t count, bool write,
+                                    int core)
+{
+    // without frames every access is a lone miss, nothing to batch
+    if (memory_.capacity() == 0)
     {
-        if (it->PID == pid)
+        for (std::size_t i = 0; i < count; i++)
         {
-            // Remove the frame from the frames list
-            frames_.remove(it->frameNumber);
+            accessAddress(pid, addresses[i], write, core);
+        }
+        return;
+    }
+
+    unsigned long long *pages = pageBuffer_.data();
 
-            // Remove entry from the page table
-            auto pageKey = std::make_pair(it->PID, it->pageNumber);
-            pageTable_.erase(pageKey);
+    for (std::size_t start = 0; start < count; start += BATCH_CHUNK)
+    {
+        std::size_t chunk = std::min(BATCH_CHUNK, count - start);
+        const unsigned long long *chunkAddresses = addresses + start;
 
-            // Erase the memory item and increment the remaining memory count
-            it = memory_.erase(it);
-            remainingMemory_++;
+        // translate the whole chunk first, branch free so the compiler can vectorize it
+        if (pageShift_ >= 0)
+        {
+            unsigned int shift = pageShift_;
+            for (std::size_t i = 0; i < chunk; i++)
+            {
+                pages[i] = chunkAddresses[i] >> shift;
+            }
         }
         else
         {
-            ++it;
+            for (std::size_t i = 0; i < chunk; i++)
+            {
+                pages[i] = chunkAddresses[i] / pageSize_;
+            }
+        }
+
+        if (analyzer_)
+        {
+            for (std::size_t i = 0; i < chunk; i++)
+            {
+                analyzer_->accessPage(pid, pages[i]);
+            }
+        }
+
+        // consecutive accesses to one page only need the first lookup, the rest are hits on its frame
+        // (a write that breaks sharing does so on the first one, the rest hit the private copy)
+        std::size_t i = 0;
+        while (i < chunk)
+        {
+            std::size_t runEnd = i + 1;
+            while (runEnd < chunk && pages[runEnd] == pages[i])
+            {
+                runEnd++;
+            }
+
+            unsigned long long frame = accessPage(pid, pages[i], write, core);
+
+            // the prefetch follows the first access, as it would on its own; it leaves the frame in place
+            if (prefetchPending_)
+            {
+                prefetch(pid, pages[i], frame);
+            }
+
+            if (runEnd - i > 1)
+            {
+                tlbs_[core].recordHits(runEnd - i - 1);
+                policy_->hit(frame, runEnd - i - 1);
+            }
+
+            i = runEnd;
         }
     }
 }
 
 /**
- * @return : memory vector
+ * Deallocates all memory accociated with a set of processes.
+ * Only the pages of those processes are visited, and every TLB is swept once for all of them.
+ * @param pids : the processes
+ * @param terminated : true at the index of every pid in pids
+ */
+void MemoryManager::deallocateMemory(const std::vector<int> &pids, const std::vector<bool> &terminated)
+{
+    for (int pid : pids)
+    {
+        // Walk only the pages mapped by this process
+        unsigned long long mapping = mappings_.firstOfProcess(pid);
+        while (mapping != NO_MAPPING)
+        {
+            unsigned long long nextMapping = mappings_.nextOfProcess(mapping);
+            unsigned long long frame = mappings_[mapping].frameNumber;
+
+            mappings_.unmap(mapping);
+
+            if (mappings_.sharers(frame) == 0)
+            {
+                // Last user of the frame, remove it from the replacement policy and release it in place
+                policy_->remove(frame);
+                if (prefetcher_)
+                {
+                    prefetcher_->released(frame);
+                }
+                memory_.release(frame);
+            }
+            else
+            {
+                // Still shared, hand the frame to its oldest remaining sharer
+                updateOwner(frame);
+            }
+
+            mapping = nextMapping;
+        }
+
+        if (prefetcher_)
+        {
+            prefetcher_->forget(pid);
+        }
+    }
+
+    for (TLB &tlb : tlbs_)
+    {
+        tlb.invalidateProcesses(terminated);
+    }
+}
+
+/**
+ * Maps every resident page of the parent into the child, sharing the frames until one of them writes.
+ * Does nothing unless copy-on-write fork is enabled.
+ * @param parentPID : pid of the forking process
+ * @param childPID : pid of the new child
+ */
+void MemoryManager::forkMemory(int parentPID, int childPID)
+{
+    if (!copyOnWriteFork_)
+    {
+        return;
+    }
+
+    for (unsigned long long mapping = mappings_.firstOfProcess(parentPID); mapping != NO_MAPPING;
+         mapping = mappings_.nextOfProcess(mapping))
+    {
+        const Mapping &entry = mappings_[mapping];
+        mappings_.map(childPID, entry.pageNumber, entry.frameNumber);
+        copyOnWriteStats_.sharedPages++;
+    }
+}
+
+/**
+ * @return : memory vector, a shared frame has one item per process mapping it
  */
 MemoryUsage MemoryManager::getMemoryUsage()
 {
-    return memory_;
+    MemoryUsage frames = memory_.occupied();
+    if (!copyOnWriteFork_)
+    {
+        return frames;
+    }
+
+    MemoryUsage usage;
+    usage.reserve(frames.size());
+    for (const MemoryItem &item : frames)
+    {
+        for (unsigned long long mapping = mappings_.firstSharer(item.frameNumber); mapping != NO_MAPPING;
+             mapping = mappings_.nextSharer(mapping))
+        {
+            usage.push_back(MemoryItem(mappings_[mapping].PID, mappings_[mapping].pageNumber, item.frameNumber));
+        }
+    }
+
+    return usage;
+}
+
+/**
+ * Makes forkMemory share the parent's frames with the child, from now on
+ */
+void MemoryManager::enableCopyOnWriteFork()
+{
+    copyOnWriteFork_ = true;
+}
+
+/**
+ * @return : pages shared by fork and copies made by writes
+ */
+CopyOnWriteStats MemoryManager::getCopyOnWriteStats() const
+{
+    return copyOnWriteStats_;
+}
+
+/**
+ * Starts feeding every access to a stack distance analyzer, from now on
+ */
+void MemoryManager::enableStackDistanceAnalysis()
+{
+    if (!analyzer_)
+    {
+        analyzer_.reset(new StackDistanceAnalyzer(pageSize_));
+    }
+}
+
+/**
+ * @return : the stack distance analyzer, nullptr if analysis is off
+ */
+const StackDistanceAnalyzer *MemoryManager::getStackDistanceAnalyzer() const
+{
+    return analyzer_.get();
+}
+
+/**
+ * Starts loading pages ahead of sequential or strided streams, from now on
+ * @param depth : pages to keep loaded ahead of a stream
+ * @param pressureDepth : pages to keep ahead when that means evicting resident pages
+ */
+void MemoryManager::enablePrefetching(unsigned int depth, unsigned int pressureDepth)
+{
+    if (!prefetcher_ && depth > 0)
+    {
+        prefetcher_.reset(new Prefetcher(depth, pressureDepth, memory_.capacity()));
+    }
+}
+
+/**
+ * @return : prefetch counters, all zero if prefetching is off
+ */
+PrefetchStats MemoryManager::getPrefetchStats() const
+{
+    return prefetcher_ ? prefetcher_->stats() : PrefetchStats();
+}
+
+/**
+ * @return : hit, miss and eviction counters of the replacement policy
+ */
+ReplacementStats MemoryManager::getReplacementStats() const
+{
+    return policy_->stats();
+}
+
+/**
+ * @return : hit, miss and invalidation counters summed over every TLB
+ */
+TLBStats MemoryManager::getTLBStats() const
+{
+    TLBStats total;
+    for (const TLB &tlb : tlbs_)
+    {
+        total.hits += tlb.stats().hits;
+        total.misses += tlb.stats().misses;
+        total.invalidations += tlb.stats().invalidations;
+    }
+
+    return total;
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+// Raed Abuzaid
+
+#include "NodePool.hpp"
+
+namespace
+{
+    constexpr std::size_t FIRST_CHUNK_NODES{64};
+    constexpr std::size_t MAX_CHUNK_NODES{4096};
+}
+
+NodePool::NodePool() : free_(nullptr), nodeSize_(0), chunkNodes_(FIRST_CHUNK_NODES) {}
+
+/**
+ * @param bytes : requested size
+ * @return : size of a node holding it
+ */
+std::size_t NodePool::roundUp(std::size_t bytes)
+{
+    // every node starts at a multiple of the strictest fundamental alignment from the chunk start
+    const std::size_t align = alignof(std::max_align_t);
+    std::size_t size = bytes < sizeof(void *) ? sizeof(void *) : bytes;
+    return (size + align - 1) / align * align;
+}
+
+/**
+ * @param bytes : size of the object
+ * @return : storage for it, from the pool if it has the node size, else from the heap
+ */
+void *NodePool::allocate(std::size_t bytes)
+{
+    std::size_t size = roundUp(bytes);
+    if (nodeSize_ == 0)
+    {
+        nodeSize_ = size;
+    }
+    else if (size != nodeSize_)
+    {
+        return ::operator new(bytes);
+    }
+
+    if (free_ == nullptr)
+    {
+        unsigned char *chunk = new unsigned char[chunkNodes_ * nodeSize_];
+        chunks_.push_back(std::unique_ptr<unsigned char[]>(chunk));
+
+        // thread the new nodes onto the free list, first node on top
+        for (std::size_t node = chunkNodes_; node-- > 0;)
+        {
+            void *storage = chunk + node * nodeSize_;
+            *static_cast<void **>(storage) = free_;
+            free_ = storage;
+        }
+
+        if (chunkNodes_ < MAX_CHUNK_NODES)
+        {
+            chunkNodes_ *= 2;
+        }
+    }
+
+    void *node = free_;
+    free_ = *static_cast<void **>(node);
+    return node;
+}
+
+/**
+ * @param node : storage allocate returned
+ * @param bytes : size passed to allocate
+ */
+void NodePool::deallocate(void *node, std::size_t bytes)
+{
+    if (roundUp(bytes) != nodeSize_)
+    {
+        ::operator delete(node);
+        return;
+    }
+
+    *static_cast<void **>(node) = free_;
+    free_ = node;
+}
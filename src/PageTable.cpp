@@ -0,0 +1,183 @@
+// Raed Abuzaid
+
+#include "PageTable.hpp"
+#include <utility>
+
+namespace
+{
+    constexpr unsigned long long MIN_CAPACITY{16};
+
+    /**
+     * @param entries : number of entries
+     * @return : smallest power of two slot count that keeps the load under 7/8
+     */
+    unsigned long long capacityFor(unsigned long long entries)
+    {
+        unsigned long long capacity = MIN_CAPACITY;
+        while (capacity / 8 * 7 < entries)
+        {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+}
+
+/**
+ * Creates an empty page table
+ * @param expectedEntries : number of entries to size the table for
+ */
+PageTable::PageTable(unsigned long long expectedEntries)
+    : slots_(capacityFor(expectedEntries)), mask_(slots_.size() - 1), size_(0) {}
+
+/**
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : home slot of the key
+ */
+unsigned long long PageTable::hash(int pid, unsigned long long pageNumber) const
+{
+    // pack the pid into the upper half so neighbouring pages of one process stay distinct, then mix
+    unsigned long long h = pageNumber ^ (static_cast<unsigned long long>(static_cast<unsigned int>(pid)) << 32);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return h & mask_;
+}
+
+/**
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : index of the slot holding the key, slots_.size() if absent
+ */
+unsigned long long PageTable::findSlot(int pid, unsigned long long pageNumber) const
+{
+    unsigned long long pos = hash(pid, pageNumber);
+
+    // an entry never sits further from home than the entries probed past it
+    for (unsigned int distance = 1; slots_[pos].distance >= distance; distance++)
+    {
+        const Slot &slot = slots_[pos];
+        if (slot.pageNumber == pageNumber && slot.PID == pid)
+        {
+            return pos;
+        }
+        pos = (pos + 1) & mask_;
+    }
+
+    return slots_.size();
+}
+
+/**
+ * Rehashes every entry into a table with the given number of slots
+ * @param capacity : new slot count, power of two
+ */
+void PageTable::rehash(unsigned long long capacity)
+{
+    std::vector<Slot> old(capacity);
+    old.swap(slots_);
+    mask_ = capacity - 1;
+    size_ = 0;
+
+    for (const Slot &slot : old)
+    {
+        if (slot.distance != 0)
+        {
+            insert(slot.PID, slot.pageNumber, slot.frameNumber);
+        }
+    }
+}
+
+/**
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : pointer to the mapped frame number, nullptr if the page is not mapped
+ */
+const unsigned long long *PageTable::find(int pid, unsigned long long pageNumber) const
+{
+    unsigned long long pos = findSlot(pid, pageNumber);
+
+    return pos == slots_.size() ? nullptr : &slots_[pos].frameNumber;
+}
+
+/**
+ * Maps a page to a frame, replacing any existing mapping
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @param frameNumber : frame number
+ */
+void PageTable::insert(int pid, unsigned long long pageNumber, unsigned long long frameNumber)
+{
+    unsigned long long existing = findSlot(pid, pageNumber);
+    if (existing != slots_.size())
+    {
+        slots_[existing].frameNumber = frameNumber;
+        return;
+    }
+
+    if (size_ + 1 > slots_.size() / 8 * 7)
+    {
+        rehash(slots_.size() * 2);
+    }
+
+    Slot entry;
+    entry.pageNumber = pageNumber;
+    entry.frameNumber = frameNumber;
+    entry.PID = pid;
+    entry.distance = 1;
+
+    // Robin Hood: take the slot from any entry that is closer to its home than we are
+    unsigned long long pos = hash(pid, pageNumber);
+    while (slots_[pos].distance != 0)
+    {
+        if (slots_[pos].distance < entry.distance)
+        {
+            std::swap(slots_[pos], entry);
+        }
+        pos = (pos + 1) & mask_;
+        entry.distance++;
+    }
+
+    slots_[pos] = entry;
+    size_++;
+}
+
+/**
+ * Removes the mapping of a page
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : true if a mapping was removed
+ */
+bool PageTable::erase(int pid, unsigned long long pageNumber)
+{
+    unsigned long long pos = findSlot(pid, pageNumber);
+    if (pos == slots_.size())
+    {
+        return false;
+    }
+
+    // backward shift the following run so no tombstone is left behind
+    unsigned long long next = (pos + 1) & mask_;
+    while (slots_[next].distance > 1)
+    {
+        slots_[pos] = slots_[next];
+        slots_[pos].distance--;
+        pos = next;
+        next = (next + 1) & mask_;
+    }
+
+    slots_[pos] = Slot();
+    size_--;
+
+    return true;
+}
+
+/**
+ * @return : number of mapped pages
+ */
+unsigned long long PageTable::size() const
+{
+    return size_;
+}
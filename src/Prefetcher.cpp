@@ -0,0 +1,242 @@
+// Raed Abuzaid
+
+#include "Prefetcher.hpp"
+#include <algorithm>
+
+namespace
+{
+    constexpr unsigned long long THROTTLE_WINDOW{64};  // resolved prefetches remembered by the throttle
+    constexpr unsigned long long THROTTLE_SAMPLES{8};  // resolved prefetches needed before it can stop a stream
+    constexpr long long MAX_STRIDE{64};                 // pages between misses still counted as one stream
+}
+
+/**
+ * @param depth : pages to keep loaded ahead of a stream
+ * @param pressureDepth : pages to keep ahead when that means evicting resident pages
+ * @param capacity : number of frames in RAM, at most half of them are used for one window
+ */
+Prefetcher::Prefetcher(unsigned int depth, unsigned int pressureDepth, unsigned long long capacity)
+    : depth_(static_cast<unsigned int>(std::min<unsigned long long>(depth, capacity / 2))),
+      pressureDepth_(std::min(pressureDepth, depth_)), clock_(0), recentUseful_(0), recentWasted_(0), heldBack_(0) {}
+
+/**
+ * Records how a prefetched page ended up, for the throttle
+ * @param useful : true if it was accessed
+ */
+void Prefetcher::resolve(bool useful)
+{
+    if (useful)
+    {
+        stats_.useful++;
+        recentUseful_++;
+    }
+    else
+    {
+        stats_.wasted++;
+        recentWasted_++;
+    }
+
+    if (recentUseful_ + recentWasted_ >= THROTTLE_WINDOW)
+    {
+        recentUseful_ /= 2;
+        recentWasted_ /= 2;
+    }
+}
+
+/**
+ * @param streams : streams of one process
+ * @param pageNumber : page just accessed
+ * @return : stream the page belongs to, a recycled one if none is close
+ */
+Prefetcher::Stream &Prefetcher::match(ProcessStreams &streams, unsigned long long pageNumber)
+{
+    Stream *nearest = nullptr;
+    Stream *oldest = &streams.streams[0];
+    long long nearestDistance = MAX_STRIDE + 1;
+
+    for (Stream &stream : streams.streams)
+    {
+        if (stream.lastUse < oldest->lastUse)
+        {
+            oldest = &stream;
+        }
+        if (stream.lastUse == 0)
+        {
+            continue;
+        }
+
+        long long step = static_cast<long long>(pageNumber - stream.lastPage);
+        if (stream.stride != 0 && step % stream.stride == 0 && step / stream.stride > 0 &&
+            step / stream.stride <= static_cast<long long>(depth_) + 1)
+        {
+            return stream; // continues along its stride, maybe skipping a few pages
+        }
+
+        long long distance = step < 0 ? -step : step;
+        if (distance < nearestDistance)
+        {
+            nearest = &stream;
+            nearestDistance = distance;
+        }
+    }
+
+    if (nearest != nullptr)
+    {
+        return *nearest;
+    }
+
+    // start over in the least recently used entry
+    oldest->lastPage = pageNumber;
+    oldest->stride = 0;
+    oldest->frontier = pageNumber;
+    return *oldest;
+}
+
+/**
+ * Trains the stream of a process on a demand miss or first access to a prefetched page
+ * and proposes the pages to load next
+ * @param pid : process pid
+ * @param pageNumber : page just accessed
+ * @param freeFrames : frames not holding any page
+ * @param pages : filled with the proposed pages, nearest first
+ */
+void Prefetcher::plan(int pid, unsigned long long pageNumber, unsigned long long freeFrames,
+                      std::vector<unsigned long long> &pages)
+{
+    pages.clear();
+
+    Stream &stream = match(streams_[pid], pageNumber);
+    stream.lastUse = ++clock_;
+
+    long long step = static_cast<long long>(pageNumber - stream.lastPage);
+    stream.lastPage = pageNumber;
+
+    if (step == 0)
+    {
+        return;
+    }
+
+    // a skip along the stride still continues the stream
+    if (stream.stride != 0 && step % stream.stride == 0 && step / stream.stride > 0)
+    {
+        step = stream.stride;
+    }
+    else
+    {
+        // a new direction, it has to repeat before anything is loaded
+        stream.stride = step;
+        stream.frontier = pageNumber;
+        return;
+    }
+
+    // strides already covered by earlier proposals
+    unsigned long long covered = 0;
+    long long ahead = static_cast<long long>(stream.frontier - pageNumber);
+    if (ahead % step == 0 && ahead / step > 0)
+    {
+        covered = ahead / step;
+    }
+
+    unsigned long long window = depth_;
+    if (depth_ > covered + freeFrames)
+    {
+        // the rest of the window would push resident pages out
+        window = pressureDepth_;
+
+        // mostly wasted lately, every load would only push out a useful page; the waste is
+        // slowly forgotten while held back so the streams get probed again later
+        unsigned long long resolved = recentUseful_ + recentWasted_;
+        if (resolved >= THROTTLE_SAMPLES && 2 * recentUseful_ < resolved)
+        {
+            window = 0;
+            if (++heldBack_ % THROTTLE_WINDOW == 0)
+            {
+                recentWasted_ /= 2;
+            }
+        }
+
+        // free frames cost nothing, only the pages past them count against the pressure window
+        window = std::max(window, covered + freeFrames);
+
+        if (depth_ > std::max(covered, window))
+        {
+            stats_.throttled += depth_ - std::max(covered, window);
+        }
+    }
+
+    for (unsigned long long i = covered + 1; i <= window; i++)
+    {
+        // stop at page 0 when walking down
+        if (step < 0 && i * static_cast<unsigned long long>(-step) > pageNumber)
+        {
+            break;
+        }
+
+        unsigned long long target = pageNumber + i * step;
+        pages.push_back(target);
+        stream.frontier = target;
+    }
+}
+
+/**
+ * Records that a prefetched page was loaded into frame
+ * @param frame : frame number
+ */
+void Prefetcher::loaded(unsigned long long frame)
+{
+    if (frame >= prefetched_.size())
+    {
+        prefetched_.resize(frame + 1, false);
+    }
+
+    prefetched_[frame] = true;
+    stats_.issued++;
+}
+
+/**
+ * Called on every access to a resident frame
+ * @param frame : frame number
+ * @return : true if this was the first access to a prefetched page
+ */
+bool Prefetcher::accessed(unsigned long long frame)
+{
+    if (frame >= prefetched_.size() || !prefetched_[frame])
+    {
+        return false;
+    }
+
+    prefetched_[frame] = false;
+    resolve(true);
+
+    return true;
+}
+
+/**
+ * Called when a frame is evicted or freed
+ * @param frame : frame number
+ */
+void Prefetcher::released(unsigned long long frame)
+{
+    if (frame < prefetched_.size() && prefetched_[frame])
+    {
+        prefetched_[frame] = false;
+        resolve(false);
+    }
+}
+
+/**
+ * Forgets the stream of a process
+ * @param pid : process pid
+ */
+void Prefetcher::forget(int pid)
+{
+    streams_.erase(pid);
+}
+
+/**
+ * @return : prefetch counters
+ */
+const PrefetchStats &Prefetcher::stats() const
+{
+    return stats_;
+}
@@ -2,7 +2,6 @@
 
 #include "ProcessManager.hpp"
 #include <vector>
-#include <algorithm>
 
 /**
  * Creates PRocess Manager object. Sets lowest PID to 1
@@ -10,16 +9,15 @@
 ProcessManager::ProcessManager() : nextPID_(1) {}
 
 /**
- * Creates a process, adds it to processes map, increments pid
+ * Creates a process, adds it to the process table, increments pid
  * @return : PID of new process
  */
 int ProcessManager::createProcess()
 {
-    Process newProcess(nextPID_);
-    processes_[newProcess.PID] = newProcess;
+    int pid = processes_.create(nextPID_).PID;
     nextPID_++;
 
-    return newProcess.PID;
+    return pid;
 }
 
 /**
@@ -30,12 +28,20 @@ int ProcessManager::createProcess()
 int ProcessManager::forkProcess(int parentPID)
 {
     // Track parent, create child
-    Process &parent = processes_[parentPID];
-    Process child(nextPID_, parentPID);
+    Process &parent = processes_.get(parentPID);
 
-    // add child to processes, and parents child vector
-    processes_[child.PID] = child;
-    parent.childrenPIDs.push_back(child.PID);
+    // add child to processes, and to the end of parents children
+    Process &child = processes_.create(nextPID_, parentPID);
+    child.prevSibling = parent.lastChild;
+    if (parent.lastChild != NO_PID)
+    {
+        processes_.get(parent.lastChild).nextSibling = child.PID;
+    }
+    else
+    {
+        parent.firstChild = child.PID;
+    }
+    parent.lastChild = child.PID;
     nextPID_++;
 
     return child.PID;
@@ -43,6 +49,7 @@ int ProcessManager::forkProcess(int parentPID)
 
 /**
  * Terminates process, as well as all decendent processes
+ * Each subsystem releases the whole subtree in a single call, so the cost is linear in the subtree and its resources
  * If parent is waiting automatically terminate, else process becomes zombie
  * @param pid : PID of process
  * @param cpu : refrence to cpu
@@ -51,31 +58,44 @@ int ProcessManager::forkProcess(int parentPID)
  */
 void ProcessManager::terminateProcess(int pid, CPU &cpu, MemoryManager &memoryManager, DiskManager &diskManager)
 {
-    Process &process = processes_[pid];
+    Process &process = processes_.get(pid);
 
-    // release memory, delete disk requests, cascading terminate chilren as well
-    memoryManager.deallocateMemory(pid);
-    diskManager.deleteRequests(pid);
-    if (process.childrenPIDs.size() > 0)
+    // release memory, delete disk requests and take off the cpu, for the process and every descendant at once
+    collectSubtree(pid);
+    memoryManager.deallocateMemory(subtree_, terminating_);
+    diskManager.deleteRequests(subtree_);
+    cpu.removeProcesses(subtree_, terminating_);
+
+    // descendants have no one left to wait for them
+    for (std::size_t i = 1; i < subtree_.size(); i++)
+    {
+        processes_.erase(subtree_[i]);
+    }
+    for (int terminated : subtree_)
     {
-        cascadingTerminate(pid, cpu, memoryManager, diskManager);
+        terminating_[terminated] = false;
     }
+    process.firstChild = NO_PID;
+    process.lastChild = NO_PID;
+    process.firstZombie = NO_PID;
 
     // check if process has parent
-    if (process.parentPID != -1)
+    if (process.parentPID != NO_PID)
     {
-        Process &parent = processes_[process.parentPID];
+        Process &parent = processes_.get(process.parentPID);
 
-        if (parent.isWaiting) // remove process from processes and from parents children vector
+        if (parent.isWaiting) // remove process from processes and from parents children
         {
+            unlinkChild(parent, process);
             processes_.erase(pid);
-            parent.childrenPIDs.erase(std::remove(parent.childrenPIDs.begin(), parent.childrenPIDs.end(), pid), parent.childrenPIDs.end());
             parent.isWaiting = false;
-            cpu.addProcess(parent.PID);
+            cpu.addProcess(parent.PID, ReadyReason::WOKEN);
         }
         else
         {
             process.isZombie = true;
+            process.nextZombie = parent.firstZombie;
+            parent.firstZombie = pid;
         }
     }
     else
@@ -94,52 +114,74 @@ void ProcessManager::terminateProcess(int pid, CPU &cpu, MemoryManager &memoryMa
  */
 void ProcessManager::waitProcess(int pid, CPU &cpu)
 {
-    Process &process = processes_[pid];
+    Process &process = processes_.get(pid);
 
-    bool resume = false;
-    for (auto it = process.childrenPIDs.begin(); it != process.childrenPIDs.end(); ++it)
+    if (process.firstZombie != NO_PID) // reap the most recent zombie
     {
-        if (processes_[*it].isZombie)
-        {
-            process.childrenPIDs.erase(it);
-            processes_.erase(*it);
-            resume = true;
-            break;
-        }
+        Process &zombie = processes_.get(process.firstZombie);
+        process.firstZombie = zombie.nextZombie;
+        unlinkChild(process, zombie);
+        processes_.erase(zombie.PID);
     }
-
-    if (!resume)
+    else
     {
         process.isWaiting = true;
-        cpu.removeRunningProcess();
+        cpu.removeProcess(pid); // off whichever core it runs on
     }
 }
 
 /**
- * Cascading terminate to prevent orphans when a process is terminated
+ * Collects a process and all its descendants into subtree_ and terminating_, without recursion
+ * so fork chains of any depth are safe
  * @param pid : process pid
- * @param cpu : refrence to cpu
- * @param diskManager : refrence to disk manager
- * @param memoryManager : refrence to memory manager
  */
-void ProcessManager::cascadingTerminate(int pid, CPU &cpu, MemoryManager &memoryManager, DiskManager &diskManager)
+void ProcessManager::collectSubtree(int pid)
 {
-    Process &process = processes_[pid];
+    if (terminating_.size() < static_cast<std::size_t>(nextPID_))
+    {
+        terminating_.resize(nextPID_, false);
+    }
+
+    subtree_.clear();
+    subtree_.push_back(pid);
+    terminating_[pid] = true;
 
-    for (int childPID : process.childrenPIDs)
+    // subtree_ doubles as the work list, everything before next has had its children added
+    for (std::size_t next = 0; next < subtree_.size(); next++)
     {
-        if (processes_[childPID].childrenPIDs.size() > 0)
+        for (int childPID = processes_.get(subtree_[next]).firstChild; childPID != NO_PID; childPID = processes_.get(childPID).nextSibling)
         {
-            cascadingTerminate(childPID, cpu, memoryManager, diskManager);
+            subtree_.push_back(childPID);
+            terminating_[childPID] = true;
         }
+    }
+}
 
-        // Delete requests made by the child process from the DiskManager
-        diskManager.deleteRequests(childPID);
-
-        // Remove the child process from the CPU's ready queue
-        cpu.removeFromReadyQueue(childPID);
+/**
+ * Takes a child out of its parent's children
+ * @param parent : the parent
+ * @param child : one of its children
+ */
+void ProcessManager::unlinkChild(Process &parent, Process &child)
+{
+    if (child.prevSibling != NO_PID)
+    {
+        processes_.get(child.prevSibling).nextSibling = child.nextSibling;
+    }
+    else
+    {
+        parent.firstChild = child.nextSibling;
+    }
 
-        // deallocate chils memory
-        memoryManager.deallocateMemory(childPID);
+    if (child.nextSibling != NO_PID)
+    {
+        processes_.get(child.nextSibling).prevSibling = child.prevSibling;
+    }
+    else
+    {
+        parent.lastChild = child.prevSibling;
     }
-}
\ No newline at end of file
+
+    child.prevSibling = NO_PID;
+    child.nextSibling = NO_PID;
+}
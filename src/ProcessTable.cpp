@@ -0,0 +1,139 @@
+// Raed Abuzaid
+
+#include "ProcessTable.hpp"
+#include <stdexcept>
+
+ProcessTable::ProcessTable() : highestPID_(-1), size_(0) {}
+
+/**
+ * @param pid : process pid
+ * @return : chunk holding the pid, nullptr if it has none
+ */
+ProcessTable::Chunk *ProcessTable::chunkOf(int pid) const
+{
+    std::size_t chunk = static_cast<std::size_t>(pid) >> CHUNK_BITS;
+    return pid >= 0 && chunk < chunks_.size() ? chunks_[chunk].get() : nullptr;
+}
+
+/**
+ * Adds a record, pids must be created in increasing order
+ * @param pid : process pid
+ * @param parentPID : parent pid, NO_PID for none
+ * @return : the new record
+ */
+Process &ProcessTable::create(int pid, int parentPID)
+{
+    if (pid < 0 || pid <= highestPID_)
+    {
+        throw std::logic_error("Process IDs must be created in increasing order.");
+    }
+
+    std::size_t index = static_cast<std::size_t>(pid) >> CHUNK_BITS;
+    if (index >= chunks_.size())
+    {
+        chunks_.resize(index + 1);
+    }
+
+    if (!chunks_[index])
+    {
+        if (!spare_.empty())
+        {
+            chunks_[index] = std::move(spare_.back());
+            spare_.pop_back();
+        }
+        else
+        {
+            chunks_[index].reset(new Chunk());
+        }
+
+        for (unsigned long long &word : chunks_[index]->live)
+        {
+            word = 0;
+        }
+        chunks_[index]->count = 0;
+    }
+
+    Chunk &chunk = *chunks_[index];
+    int slot = pid & (CHUNK_SIZE - 1);
+
+    chunk.records[slot] = Process(pid, parentPID);
+    chunk.live[slot / 64] |= 1ULL << (slot % 64);
+    chunk.count++;
+    highestPID_ = pid;
+    size_++;
+
+    return chunk.records[slot];
+}
+
+/**
+ * @param pid : process pid
+ * @return : record of the process, nullptr if it does not exist
+ */
+Process *ProcessTable::find(int pid)
+{
+    Chunk *chunk = chunkOf(pid);
+    int slot = pid & (CHUNK_SIZE - 1);
+
+    if (chunk == nullptr || !(chunk->live[slot / 64] >> (slot % 64) & 1ULL))
+    {
+        return nullptr;
+    }
+
+    return &chunk->records[slot];
+}
+
+/**
+ * Record of a process that must exist
+ * @param pid : process pid
+ * @return : record of the process
+ */
+Process &ProcessTable::get(int pid)
+{
+    Process *process = find(pid);
+    if (process == nullptr)
+    {
+        throw std::logic_error("Process does not exist.");
+    }
+
+    return *process;
+}
+
+/**
+ * Removes a record, recycling its chunk if nothing in it can be used again
+ * @param pid : process pid
+ * @return : true if the record existed
+ */
+bool ProcessTable::erase(int pid)
+{
+    Process *process = find(pid);
+    if (process == nullptr)
+    {
+        return false;
+    }
+
+    std::size_t index = static_cast<std::size_t>(pid) >> CHUNK_BITS;
+    Chunk &chunk = *chunks_[index];
+    int slot = pid & (CHUNK_SIZE - 1);
+
+    *process = Process();
+    chunk.live[slot / 64] &= ~(1ULL << (slot % 64));
+    chunk.count--;
+    size_--;
+
+    // every pid of the chunk has been handed out and reaped
+    bool exhausted = static_cast<long long>(index + 1) * CHUNK_SIZE - 1 <= highestPID_;
+    if (chunk.count == 0 && exhausted)
+    {
+        spare_.push_back(std::move(chunks_[index]));
+    }
+
+    return true;
+}
+
+/**
+ * @return : number of records
+ */
+std::size_t ProcessTable::size() const
+{
+    return size_;
+}
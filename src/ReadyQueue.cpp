@@ -0,0 +1,191 @@
+// Raed Abuzaid
+
+#include "ReadyQueue.hpp"
+
+namespace
+{
+    constexpr int NOT_QUEUED{-1};
+}
+
+/**
+ * @param queues : number of queues, slots 0..queues-1 are their sentinels and pid p lives in slot p + queues
+ */
+ReadyQueue::ReadyQueue(std::size_t queues) : prev_(queues), next_(queues), queue_(queues), sizes_(queues, 0)
+{
+    for (std::size_t sentinel = 0; sentinel < queues; sentinel++)
+    {
+        prev_[sentinel] = sentinel;
+        next_[sentinel] = sentinel;
+        queue_[sentinel] = sentinel;
+    }
+}
+
+/**
+ * @param pid : process pid
+ * @return : slot of the pid in the link arrays
+ */
+int ReadyQueue::slot(int pid) const
+{
+    return pid + static_cast<int>(sizes_.size());
+}
+
+/**
+ * Links a process into a queue at either end, moving it there if it is already queued
+ * @param pid : process pid, negative pids are ignored
+ * @param queue : queue index
+ * @param front : true to link it at the front, false at the back
+ */
+void ReadyQueue::link(int pid, std::size_t queue, bool front)
+{
+    if (pid < 0)
+    {
+        return;
+    }
+
+    int self = slot(pid);
+    if (static_cast<std::size_t>(self) >= next_.size())
+    {
+        prev_.resize(self + 1, NOT_QUEUED);
+        next_.resize(self + 1, NOT_QUEUED);
+        queue_.resize(self + 1, NOT_QUEUED);
+    }
+
+    remove(pid);
+
+    int sentinel = static_cast<int>(queue);
+    int before = front ? sentinel : prev_[sentinel];
+    int after = next_[before];
+    prev_[self] = before;
+    next_[self] = after;
+    next_[before] = self;
+    prev_[after] = self;
+    queue_[self] = sentinel;
+    sizes_[queue]++;
+}
+
+/**
+ * Adds a process to the back of a queue, moving it there if it is already queued
+ * @param pid : process pid, negative pids are ignored
+ * @param queue : queue index
+ */
+void ReadyQueue::pushBack(int pid, std::size_t queue)
+{
+    link(pid, queue, false);
+}
+
+/**
+ * Adds a process to the front of a queue, moving it there if it is already queued
+ * @param pid : process pid, negative pids are ignored
+ * @param queue : queue index
+ */
+void ReadyQueue::pushFront(int pid, std::size_t queue)
+{
+    link(pid, queue, true);
+}
+
+/**
+ * Removes the process at the front of a queue
+ * @param queue : queue index
+ * @return : its pid, NO_PROCESS if the queue is empty
+ */
+int ReadyQueue::popFront(std::size_t queue)
+{
+    if (sizes_[queue] == 0)
+    {
+        return NO_PROCESS;
+    }
+
+    int pid = next_[queue] - static_cast<int>(sizes_.size());
+    remove(pid);
+
+    return pid;
+}
+
+/**
+ * Removes the process at the back of a queue
+ * @param queue : queue index
+ * @return : its pid, NO_PROCESS if the queue is empty
+ */
+int ReadyQueue::popBack(std::size_t queue)
+{
+    if (sizes_[queue] == 0)
+    {
+        return NO_PROCESS;
+    }
+
+    int pid = prev_[queue] - static_cast<int>(sizes_.size());
+    remove(pid);
+
+    return pid;
+}
+
+/**
+ * Removes a process from whichever queue holds it, does nothing if it is not queued
+ * @param pid : process pid
+ */
+void ReadyQueue::remove(int pid)
+{
+    if (!contains(pid))
+    {
+        return;
+    }
+
+    int self = slot(pid);
+    next_[prev_[self]] = next_[self];
+    prev_[next_[self]] = prev_[self];
+    sizes_[queue_[self]]--;
+    prev_[self] = NOT_QUEUED;
+    next_[self] = NOT_QUEUED;
+    queue_[self] = NOT_QUEUED;
+}
+
+/**
+ * @param pid : process pid
+ * @return : true if the process is queued
+ */
+bool ReadyQueue::contains(int pid) const
+{
+    return pid >= 0 && static_cast<std::size_t>(slot(pid)) < next_.size() && next_[slot(pid)] != NOT_QUEUED;
+}
+
+/**
+ * @param pid : process pid
+ * @return : queue holding the process, -1 if it is not queued
+ */
+int ReadyQueue::queueOf(int pid) const
+{
+    return contains(pid) ? queue_[slot(pid)] : -1;
+}
+
+/**
+ * @param queue : queue index
+ * @return : true if no process is in the queue
+ */
+bool ReadyQueue::empty(std::size_t queue) const
+{
+    return sizes_[queue] == 0;
+}
+
+/**
+ * @param queue : queue index
+ * @return : number of processes in the queue
+ */
+std::size_t ReadyQueue::size(std::size_t queue) const
+{
+    return sizes_[queue];
+}
+
+/**
+ * @param queue : queue index
+ * @return : pids of the queue from front to back
+ */
+std::deque<int> ReadyQueue::toDeque(std::size_t queue) const
+{
+    std::deque<int> pids;
+    for (int self = next_[queue]; self != static_cast<int>(queue); self = next_[self])
+    {
+        pids.push_back(self - static_cast<int>(sizes_.size()));
+    }
+
+    return pids;
+}
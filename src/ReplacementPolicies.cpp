@@ -0,0 +1,612 @@
+// Raed Abuzaid
+
+#include "ReplacementPolicies.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    constexpr unsigned char NOT_RESIDENT{0};
+    constexpr unsigned char RESIDENT{1};
+    constexpr unsigned char REFERENCED{2};
+
+    /**
+     * Grows a per-frame array so that frame has a slot
+     * @param values : per-frame array
+     * @param frame : frame number
+     * @param fill : value for new slots
+     */
+    template <typename T>
+    void reserveFrame(std::vector<T> &values, unsigned long long frame, T fill)
+    {
+        if (frame >= values.size())
+        {
+            values.resize(frame + 1, fill);
+        }
+    }
+}
+
+/**
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : true if the page is remembered
+ */
+bool GhostList::contains(int pid, unsigned long long pageNumber) const
+{
+    return index_.find(pid, pageNumber) != nullptr;
+}
+
+/**
+ * Remembers a page as the newest entry
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void GhostList::push(int pid, unsigned long long pageNumber)
+{
+    erase(pid, pageNumber);
+
+    unsigned long long slot = entries_.size();
+    if (!freeSlots_.empty())
+    {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+    else
+    {
+        entries_.push_back(Entry());
+    }
+
+    entries_[slot].PID = pid;
+    entries_[slot].pageNumber = pageNumber;
+    index_.insert(pid, pageNumber, slot);
+    order_.touch(slot);
+}
+
+/**
+ * Forgets a page
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : true if the page was remembered
+ */
+bool GhostList::erase(int pid, unsigned long long pageNumber)
+{
+    const unsigned long long *slot = index_.find(pid, pageNumber);
+    if (slot == nullptr)
+    {
+        return false;
+    }
+
+    unsigned long long freed = *slot;
+    order_.unlink(freed);
+    index_.erase(pid, pageNumber);
+    freeSlots_.push_back(freed);
+
+    return true;
+}
+
+/**
+ * Forgets the oldest page, does nothing if the list is empty
+ */
+void GhostList::dropOldest()
+{
+    unsigned long long slot = order_.evict();
+    if (slot != NO_FRAME)
+    {
+        index_.erase(entries_[slot].PID, entries_[slot].pageNumber);
+        freeSlots_.push_back(slot);
+    }
+}
+
+/**
+ * @return : number of remembered pages
+ */
+unsigned long long GhostList::size() const
+{
+    return order_.size();
+}
+
+// LRU
+
+void LRUPolicy::onHit(unsigned long long frame)
+{
+    frames_.touch(frame);
+}
+
+unsigned long long LRUPolicy::selectVictim()
+{
+    return frames_.evictExcept(pinned());
+}
+
+void LRUPolicy::onInsert(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    frames_.touch(frame);
+}
+
+void LRUPolicy::onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    frames_.demote(frame);
+}
+
+void LRUPolicy::onRemove(unsigned long long frame)
+{
+    frames_.unlink(frame);
+}
+
+// CLOCK
+
+// Default constructor
+ClockPolicy::ClockPolicy() : hand_(0) {}
+
+void ClockPolicy::onHit(unsigned long long frame)
+{
+    state_[frame] = REFERENCED;
+}
+
+unsigned long long ClockPolicy::selectVictim()
+{
+    // RAM is full, so the hand finds a victim within two sweeps
+    for (;;)
+    {
+        if (hand_ >= state_.size())
+        {
+            hand_ = 0;
+        }
+
+        unsigned long long frame = hand_++;
+        if (frame == pinned())
+        {
+            continue; // passed over without losing its reference bit
+        }
+
+        if (state_[frame] == REFERENCED)
+        {
+            state_[frame] = RESIDENT;
+        }
+        else if (state_[frame] == RESIDENT)
+        {
+            state_[frame] = NOT_RESIDENT;
+            return frame;
+        }
+    }
+}
+
+void ClockPolicy::onInsert(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(state_, frame, NOT_RESIDENT);
+    state_[frame] = REFERENCED;
+}
+
+void ClockPolicy::onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(state_, frame, NOT_RESIDENT);
+    state_[frame] = RESIDENT; // no reference bit, the hand takes it on its first pass
+}
+
+void ClockPolicy::onRemove(unsigned long long frame)
+{
+    state_[frame] = NOT_RESIDENT;
+}
+
+// Second chance
+
+void SecondChancePolicy::onHit(unsigned long long frame)
+{
+    referenced_[frame] = true;
+}
+
+unsigned long long SecondChancePolicy::selectVictim()
+{
+    for (;;)
+    {
+        unsigned long long frame = queue_.evictExcept(pinned());
+        if (!referenced_[frame])
+        {
+            return frame;
+        }
+
+        // give the frame a second chance at the back of the queue
+        referenced_[frame] = false;
+        queue_.touch(frame);
+    }
+}
+
+void SecondChancePolicy::onInsert(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(referenced_, frame, false);
+    referenced_[frame] = true;
+    queue_.touch(frame);
+}
+
+void SecondChancePolicy::onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(referenced_, frame, false);
+    referenced_[frame] = false;
+    queue_.demote(frame);
+}
+
+void SecondChancePolicy::onRemove(unsigned long long frame)
+{
+    queue_.unlink(frame);
+}
+
+// LFU
+
+/**
+ * Links frame as the newest entry of the bucket for its count
+ * @param frame : frame number
+ */
+void LFUPolicy::link(unsigned long long frame)
+{
+    Bucket &bucket = buckets_[count_[frame]];
+
+    older_[frame] = bucket.newest;
+    newer_[frame] = NO_FRAME;
+    if (bucket.newest != NO_FRAME)
+    {
+        newer_[bucket.newest] = frame;
+    }
+    else
+    {
+        bucket.oldest = frame;
+    }
+    bucket.newest = frame;
+}
+
+/**
+ * Links frame as the oldest entry of the bucket for its count
+ * @param frame : frame number
+ */
+void LFUPolicy::linkOldest(unsigned long long frame)
+{
+    Bucket &bucket = buckets_[count_[frame]];
+
+    newer_[frame] = bucket.oldest;
+    older_[frame] = NO_FRAME;
+    if (bucket.oldest != NO_FRAME)
+    {
+        older_[bucket.oldest] = frame;
+    }
+    else
+    {
+        bucket.newest = frame;
+    }
+    bucket.oldest = frame;
+}
+
+/**
+ * Unlinks frame from the bucket for its count, dropping the bucket if it empties
+ * @param frame : frame number
+ */
+void LFUPolicy::unlink(unsigned long long frame)
+{
+    auto bucket = buckets_.find(count_[frame]);
+    unsigned long long older = older_[frame];
+    unsigned long long newer = newer_[frame];
+
+    if (older != NO_FRAME)
+    {
+        newer_[older] = newer;
+    }
+    else
+    {
+        bucket->second.oldest = newer;
+    }
+
+    if (newer != NO_FRAME)
+    {
+        older_[newer] = older;
+    }
+    else
+    {
+        bucket->second.newest = older;
+    }
+
+    if (bucket->second.oldest == NO_FRAME)
+    {
+        buckets_.erase(bucket);
+    }
+}
+
+void LFUPolicy::onHit(unsigned long long frame)
+{
+    onRepeatedHits(frame, 1);
+}
+
+void LFUPolicy::onRepeatedHits(unsigned long long frame, unsigned long long count)
+{
+    // a prefetched page starts counting at its first real access
+    if (cold_[frame])
+    {
+        cold_[frame] = false;
+        count--;
+    }
+
+    unlink(frame);
+    count_[frame] += count;
+    link(frame);
+}
+
+unsigned long long LFUPolicy::selectVictim()
+{
+    unsigned long long frame = buckets_.begin()->second.oldest;
+    if (frame == pinned())
+    {
+        // the pinned frame keeps its place, the next oldest goes instead
+        frame = newer_[frame] != NO_FRAME ? newer_[frame] : std::next(buckets_.begin())->second.oldest;
+    }
+
+    unlink(frame);
+    count_[frame] = 0;
+
+    return frame;
+}
+
+void LFUPolicy::onInsert(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(count_, frame, 0ULL);
+    reserveFrame(newer_, frame, NO_FRAME);
+    reserveFrame(older_, frame, NO_FRAME);
+
+    reserveFrame(cold_, frame, false);
+
+    count_[frame] = 1;
+    cold_[frame] = false;
+    link(frame);
+}
+
+void LFUPolicy::onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(count_, frame, 0ULL);
+    reserveFrame(newer_, frame, NO_FRAME);
+    reserveFrame(older_, frame, NO_FRAME);
+
+    reserveFrame(cold_, frame, false);
+
+    count_[frame] = 1;
+    cold_[frame] = true;
+    linkOldest(frame);
+}
+
+void LFUPolicy::onRemove(unsigned long long frame)
+{
+    if (count_[frame] != 0)
+    {
+        unlink(frame);
+        count_[frame] = 0;
+    }
+}
+
+// ARC
+
+/**
+ * @param capacity : number of frames in RAM
+ */
+ARCPolicy::ARCPolicy(unsigned long long capacity)
+    : capacity_(capacity), target_(0), missedInFrequentGhosts_(false), promoteMiss_(false) {}
+
+/**
+ * @param frame : frame number
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void ARCPolicy::remember(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(pids_, frame, -1);
+    reserveFrame(pages_, frame, 0ULL);
+    reserveFrame(cold_, frame, false);
+    pids_[frame] = pid;
+    pages_[frame] = pageNumber;
+    cold_[frame] = false;
+}
+
+void ARCPolicy::onHit(unsigned long long frame)
+{
+    // the first real access to a prefetched page counts as its first access, not its second
+    if (cold_[frame])
+    {
+        cold_[frame] = false;
+        recent_.touch(frame);
+        return;
+    }
+
+    recent_.unlink(frame);
+    frequent_.touch(frame);
+}
+
+void ARCPolicy::onMiss(int pid, unsigned long long pageNumber)
+{
+    unsigned long long recentGhosts = recentGhosts_.size();
+    unsigned long long frequentGhosts = frequentGhosts_.size();
+
+    missedInFrequentGhosts_ = false;
+    promoteMiss_ = true;
+
+    if (recentGhosts_.erase(pid, pageNumber))
+    {
+        // T1 was too small, grow its target
+        target_ = std::min(capacity_, target_ + std::max(frequentGhosts / recentGhosts, 1ULL));
+    }
+    else if (frequentGhosts_.erase(pid, pageNumber))
+    {
+        // T2 was too small, shrink the target of T1
+        target_ -= std::min(target_, std::max(recentGhosts / frequentGhosts, 1ULL));
+        missedInFrequentGhosts_ = true;
+    }
+    else
+    {
+        promoteMiss_ = false;
+
+        // keep the history bounded, |T1| + |B1| <= c and everything <= 2c
+        if (recent_.size() + recentGhosts >= capacity_ && recentGhosts > 0)
+        {
+            recentGhosts_.dropOldest();
+        }
+        else if (recent_.size() + frequent_.size() + recentGhosts + frequentGhosts >= 2 * capacity_)
+        {
+            frequentGhosts_.dropOldest();
+        }
+    }
+}
+
+unsigned long long ARCPolicy::selectVictim()
+{
+    unsigned long long recentSize = recent_.size();
+    bool fromRecent = recentSize > 0 && (recentSize > target_ || (missedInFrequentGhosts_ && recentSize == target_) || frequent_.size() == 0);
+
+    unsigned long long frame = fromRecent ? recent_.evictExcept(pinned()) : frequent_.evictExcept(pinned());
+    if (frame == NO_FRAME)
+    {
+        // the chosen list only holds the pinned frame, the other one gives way
+        fromRecent = !fromRecent;
+        frame = fromRecent ? recent_.evictExcept(pinned()) : frequent_.evictExcept(pinned());
+    }
+
+    if (fromRecent)
+    {
+        // a prefetched page that was never used has no history worth keeping
+        if (!cold_[frame])
+        {
+            recentGhosts_.push(pids_[frame], pages_[frame]);
+        }
+        cold_[frame] = false;
+    }
+    else
+    {
+        frequentGhosts_.push(pids_[frame], pages_[frame]);
+    }
+
+    while (recent_.size() + recentGhosts_.size() > capacity_ && recentGhosts_.size() > 0)
+    {
+        recentGhosts_.dropOldest();
+    }
+    while (recent_.size() + frequent_.size() + recentGhosts_.size() + frequentGhosts_.size() > 2 * capacity_ && frequentGhosts_.size() > 0)
+    {
+        frequentGhosts_.dropOldest();
+    }
+
+    return frame;
+}
+
+void ARCPolicy::onInsert(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    remember(frame, pid, pageNumber);
+
+    if (promoteMiss_)
+    {
+        frequent_.touch(frame);
+    }
+    else
+    {
+        recent_.touch(frame);
+    }
+}
+
+void ARCPolicy::onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    // seen zero times, so it goes below everything in T1
+    remember(frame, pid, pageNumber);
+    cold_[frame] = true;
+    recent_.demote(frame);
+}
+
+void ARCPolicy::onRemove(unsigned long long frame)
+{
+    recent_.unlink(frame);
+    frequent_.unlink(frame);
+}
+
+// 2Q
+
+/**
+ * @param capacity : number of frames in RAM
+ */
+TwoQueuePolicy::TwoQueuePolicy(unsigned long long capacity)
+    : inCapacity_(std::max(capacity / 4, 1ULL)), outCapacity_(std::max(capacity / 2, 1ULL)), promoteMiss_(false) {}
+
+void TwoQueuePolicy::onHit(unsigned long long frame)
+{
+    // the first real access to a prefetched page is its arrival
+    if (cold_[frame])
+    {
+        cold_[frame] = false;
+        in_.touch(frame);
+        return;
+    }
+
+    // a hit while still in A1in says nothing about long term reuse
+    if (main_.contains(frame))
+    {
+        main_.touch(frame);
+    }
+}
+
+void TwoQueuePolicy::onMiss(int pid, unsigned long long pageNumber)
+{
+    promoteMiss_ = out_.erase(pid, pageNumber);
+}
+
+unsigned long long TwoQueuePolicy::selectVictim()
+{
+    bool fromIn = in_.size() > inCapacity_ || main_.size() == 0;
+
+    unsigned long long frame = fromIn ? in_.evictExcept(pinned()) : main_.evictExcept(pinned());
+    if (frame == NO_FRAME)
+    {
+        // the chosen queue only holds the pinned frame, the other one gives way
+        fromIn = !fromIn;
+        frame = fromIn ? in_.evictExcept(pinned()) : main_.evictExcept(pinned());
+    }
+
+    if (fromIn)
+    {
+        // a prefetched page that was never used has no history worth keeping
+        if (!cold_[frame])
+        {
+            out_.push(pids_[frame], pages_[frame]);
+            if (out_.size() > outCapacity_)
+            {
+                out_.dropOldest();
+            }
+        }
+        cold_[frame] = false;
+    }
+
+    return frame;
+}
+
+void TwoQueuePolicy::onInsert(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(pids_, frame, -1);
+    reserveFrame(pages_, frame, 0ULL);
+    reserveFrame(cold_, frame, false);
+    pids_[frame] = pid;
+    pages_[frame] = pageNumber;
+    cold_[frame] = false;
+
+    if (promoteMiss_)
+    {
+        main_.touch(frame);
+    }
+    else
+    {
+        in_.touch(frame);
+    }
+}
+
+void TwoQueuePolicy::onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    reserveFrame(pids_, frame, -1);
+    reserveFrame(pages_, frame, 0ULL);
+    reserveFrame(cold_, frame, false);
+    pids_[frame] = pid;
+    pages_[frame] = pageNumber;
+    cold_[frame] = true;
+
+    in_.demote(frame);
+}
+
+void TwoQueuePolicy::onRemove(unsigned long long frame)
+{
+    in_.unlink(frame);
+    main_.unlink(frame);
+}
@@ -0,0 +1,161 @@
+// Raed Abuzaid
+
+#include "ReplacementPolicy.hpp"
+#include "ReplacementPolicies.hpp"
+
+// Default constructor
+ReplacementPolicy::ReplacementPolicy() : pinned_(NO_FRAME) {}
+
+/**
+ * Resident page in frame was accessed several times in a row, with nothing in between.
+ * Counts as one hit unless the policy keeps a count, only the first hit of a run changes recency.
+ * @param frame : frame number
+ * @param count : number of accesses
+ */
+void ReplacementPolicy::onRepeatedHits(unsigned long long frame, unsigned long long count)
+{
+    onHit(frame);
+}
+
+/**
+ * A page that is not resident was accessed, called before any eviction for it
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void ReplacementPolicy::onMiss(int pid, unsigned long long pageNumber) {}
+
+/**
+ * A page nobody asked for yet (a prefetch) now lives in frame, it should be among the first to go
+ * @param frame : frame number
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void ReplacementPolicy::onInsertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    onInsert(frame, pid, pageNumber);
+}
+
+/**
+ * @return : frame selectVictim must pass over, NO_FRAME if none
+ */
+unsigned long long ReplacementPolicy::pinned() const
+{
+    return pinned_;
+}
+
+/**
+ * Records an access to a resident page
+ * @param frame : frame number
+ */
+void ReplacementPolicy::hit(unsigned long long frame)
+{
+    stats_.hits++;
+    onHit(frame);
+}
+
+/**
+ * Records several back to back accesses to a resident page
+ * @param frame : frame number
+ * @param count : number of accesses
+ */
+void ReplacementPolicy::hit(unsigned long long frame, unsigned long long count)
+{
+    stats_.hits += count;
+    onRepeatedHits(frame, count);
+}
+
+/**
+ * Records an access to a page that must be loaded
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void ReplacementPolicy::miss(int pid, unsigned long long pageNumber)
+{
+    stats_.misses++;
+    onMiss(pid, pageNumber);
+}
+
+/**
+ * Chooses the frame to replace, RAM must be full
+ * @return : frame to replace
+ */
+unsigned long long ReplacementPolicy::evict()
+{
+    stats_.evictions++;
+    return selectVictim();
+}
+
+/**
+ * Keeps frame resident through the following evictions, until another frame is pinned.
+ * At least one other frame must be resident whenever evict is called.
+ * @param frame : frame number, NO_FRAME releases the pin
+ */
+void ReplacementPolicy::pin(unsigned long long frame)
+{
+    pinned_ = frame;
+}
+
+/**
+ * Records that the missed page was placed in frame
+ * @param frame : frame number
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void ReplacementPolicy::insert(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    onInsert(frame, pid, pageNumber);
+}
+
+/**
+ * Records that a prefetched page was placed in frame, at the lowest priority
+ * @param frame : frame number
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void ReplacementPolicy::insertCold(unsigned long long frame, int pid, unsigned long long pageNumber)
+{
+    onInsertCold(frame, pid, pageNumber);
+}
+
+/**
+ * Records that frame was released by its process
+ * @param frame : frame number
+ */
+void ReplacementPolicy::remove(unsigned long long frame)
+{
+    onRemove(frame);
+}
+
+/**
+ * @return : hit, miss and eviction counters
+ */
+const ReplacementStats &ReplacementPolicy::stats() const
+{
+    return stats_;
+}
+
+/**
+ * Creates a replacement policy
+ * @param type : policy to create
+ * @param capacity : number of frames in RAM
+ * @return : the new policy
+ */
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(ReplacementPolicyType type, unsigned long long capacity)
+{
+    switch (type)
+    {
+    case ReplacementPolicyType::CLOCK:
+        return std::unique_ptr<ReplacementPolicy>(new ClockPolicy());
+    case ReplacementPolicyType::SECOND_CHANCE:
+        return std::unique_ptr<ReplacementPolicy>(new SecondChancePolicy());
+    case ReplacementPolicyType::LFU:
+        return std::unique_ptr<ReplacementPolicy>(new LFUPolicy());
+    case ReplacementPolicyType::ARC:
+        return std::unique_ptr<ReplacementPolicy>(new ARCPolicy(capacity));
+    case ReplacementPolicyType::TWO_Q:
+        return std::unique_ptr<ReplacementPolicy>(new TwoQueuePolicy(capacity));
+    case ReplacementPolicyType::LRU:
+    default:
+        return std::unique_ptr<ReplacementPolicy>(new LRUPolicy());
+    }
+}
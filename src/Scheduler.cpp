@@ -0,0 +1,84 @@
+// Raed Abuzaid
+
+#include "Scheduler.hpp"
+#include "Schedulers.hpp"
+
+/**
+ * The priority of a process changed
+ * @param pid : process pid
+ */
+void Scheduler::onPriorityChange(int pid) {}
+
+/**
+ * @param pid : process that just became ready
+ * @param running : process running on its core
+ * @return : true if pid should take the core right away
+ */
+bool Scheduler::preempts(int pid, int running) const
+{
+    return false;
+}
+
+/**
+ * @param core : core index
+ * @return : true if nothing is ready on the core
+ */
+bool Scheduler::empty(int core) const
+{
+    return size(core) == 0;
+}
+
+/**
+ * @param pid : process pid
+ * @param priority : 0 is the highest, PRIORITY_LEVELS - 1 the lowest
+ */
+void Scheduler::setPriority(int pid, int priority)
+{
+    if (pid < 0)
+    {
+        return;
+    }
+    if (static_cast<std::size_t>(pid) >= priorities_.size())
+    {
+        priorities_.resize(pid + 1, DEFAULT_PRIORITY);
+    }
+
+    priorities_[pid] = priority;
+    onPriorityChange(pid);
+}
+
+/**
+ * @param pid : process pid
+ * @return : its priority, DEFAULT_PRIORITY if none was set
+ */
+int Scheduler::getPriority(int pid) const
+{
+    if (pid < 0 || static_cast<std::size_t>(pid) >= priorities_.size())
+    {
+        return DEFAULT_PRIORITY;
+    }
+
+    return priorities_[pid];
+}
+
+/**
+ * Creates a scheduler
+ * @param type : scheduler to create
+ * @param cores : number of cores
+ * @return : the new scheduler
+ */
+std::unique_ptr<Scheduler> makeScheduler(SchedulerType type, int cores)
+{
+    switch (type)
+    {
+    case SchedulerType::PRIORITY:
+        return std::unique_ptr<Scheduler>(new PriorityScheduler(cores));
+    case SchedulerType::MLFQ:
+        return std::unique_ptr<Scheduler>(new MLFQScheduler(cores));
+    case SchedulerType::FAIR:
+        return std::unique_ptr<Scheduler>(new FairScheduler(cores));
+    case SchedulerType::ROUND_ROBIN:
+    default:
+        return std::unique_ptr<Scheduler>(new RoundRobinScheduler(cores));
+    }
+}
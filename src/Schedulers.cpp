@@ -0,0 +1,420 @@
+// Raed Abuzaid
+
+#include "Schedulers.hpp"
+#include <algorithm>
+
+namespace
+{
+    constexpr int MLFQ_LEVELS{8};
+    constexpr long long TIME_SLICE{1 << 20};            // virtual runtime of one slice at the default priority
+    constexpr long long SLEEPER_CREDIT{TIME_SLICE / 2}; // how far behind the core's minimum a woken process may start
+
+    // weight of each priority, every step is about 25% more or less CPU (the Linux nice table)
+    constexpr long long PRIORITY_WEIGHTS[PRIORITY_LEVELS] = {
+        88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+        9548, 7620, 6100, 4904, 3906, 3121, 2501, 1991, 1586, 1277,
+        1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+        110, 87, 70, 56, 45, 36, 29, 23, 18, 15};
+
+    /**
+     * Grows a per-pid array so that pid has a slot
+     * @param values : per-pid array
+     * @param pid : process pid
+     * @param fill : value for new slots
+     */
+    template <typename T>
+    void reservePid(std::vector<T> &values, int pid, T fill)
+    {
+        if (static_cast<std::size_t>(pid) >= values.size())
+        {
+            values.resize(pid + 1, fill);
+        }
+    }
+}
+
+// Round robin
+
+RoundRobinScheduler::RoundRobinScheduler(int cores) : queues_(cores) {}
+
+void RoundRobinScheduler::enqueue(int pid, int core, ReadyReason reason)
+{
+    if (reason == ReadyReason::PREEMPTED)
+    {
+        queues_.pushFront(pid, core);
+    }
+    else
+    {
+        queues_.pushBack(pid, core);
+    }
+}
+
+int RoundRobinScheduler::pickNext(int core)
+{
+    return queues_.popFront(core);
+}
+
+int RoundRobinScheduler::steal(int core)
+{
+    return queues_.popBack(core); // the process that would wait longest there
+}
+
+void RoundRobinScheduler::remove(int pid)
+{
+    queues_.remove(pid);
+}
+
+std::size_t RoundRobinScheduler::size(int core) const
+{
+    return queues_.size(core);
+}
+
+std::deque<int> RoundRobinScheduler::toDeque(int core) const
+{
+    return queues_.toDeque(core);
+}
+
+// Buckets
+
+BucketScheduler::BucketScheduler(int cores, int levels)
+    : levelCount_(levels), buckets_(static_cast<std::size_t>(cores) * levels), bitmaps_(cores, 0), sizes_(cores, 0) {}
+
+/**
+ * Queues a process in the bucket of its current level
+ * @param pid : process pid
+ * @param core : core index
+ * @param front : true to queue it ahead of its level, false behind
+ */
+void BucketScheduler::link(int pid, int core, bool front)
+{
+    int lvl = level(pid);
+    int bucket = core * levelCount_ + lvl;
+
+    if (front)
+    {
+        buckets_.pushFront(pid, bucket);
+    }
+    else
+    {
+        buckets_.pushBack(pid, bucket);
+    }
+    bitmaps_[core] |= std::uint64_t(1) << lvl;
+    sizes_[core]++;
+}
+
+/**
+ * Takes a process out of its bucket and keeps the bitmap in step
+ * @param pid : queued process pid, or one just popped from the bucket
+ * @param bucket : its bucket
+ */
+void BucketScheduler::unlink(int pid, int bucket)
+{
+    int core = bucket / levelCount_;
+
+    buckets_.remove(pid);
+    if (buckets_.empty(bucket))
+    {
+        bitmaps_[core] &= ~(std::uint64_t(1) << (bucket % levelCount_));
+    }
+    sizes_[core]--;
+}
+
+/**
+ * Called before a process is queued, so the level can follow its behaviour
+ * @param pid : process pid
+ * @param reason : why it became ready
+ */
+void BucketScheduler::onEnqueue(int pid, ReadyReason reason) {}
+
+void BucketScheduler::onPriorityChange(int pid)
+{
+    int bucket = buckets_.queueOf(pid);
+    if (bucket != -1 && bucket % levelCount_ != level(pid))
+    {
+        unlink(pid, bucket);
+        link(pid, bucket / levelCount_, false);
+    }
+}
+
+void BucketScheduler::enqueue(int pid, int core, ReadyReason reason)
+{
+    if (pid < 0)
+    {
+        return;
+    }
+
+    remove(pid);
+    onEnqueue(pid, reason);
+    link(pid, core, reason == ReadyReason::PREEMPTED);
+}
+
+int BucketScheduler::pickNext(int core)
+{
+    if (bitmaps_[core] == 0)
+    {
+        return NO_PROCESS;
+    }
+
+    int bucket = core * levelCount_ + __builtin_ctzll(bitmaps_[core]);
+    int pid = buckets_.popFront(bucket);
+    unlink(pid, bucket);
+
+    return pid;
+}
+
+int BucketScheduler::steal(int core)
+{
+    if (bitmaps_[core] == 0)
+    {
+        return NO_PROCESS;
+    }
+
+    // the back of the worst level waits longest
+    int bucket = core * levelCount_ + 63 - __builtin_clzll(bitmaps_[core]);
+    int pid = buckets_.popBack(bucket);
+    unlink(pid, bucket);
+
+    return pid;
+}
+
+void BucketScheduler::remove(int pid)
+{
+    int bucket = buckets_.queueOf(pid);
+    if (bucket != -1)
+    {
+        unlink(pid, bucket);
+    }
+}
+
+bool BucketScheduler::preempts(int pid, int running) const
+{
+    return level(pid) < level(running);
+}
+
+std::size_t BucketScheduler::size(int core) const
+{
+    return sizes_[core];
+}
+
+std::deque<int> BucketScheduler::toDeque(int core) const
+{
+    std::deque<int> pids;
+    std::uint64_t remaining = bitmaps_[core];
+    while (remaining != 0)
+    {
+        std::deque<int> bucket = buckets_.toDeque(core * levelCount_ + __builtin_ctzll(remaining));
+        pids.insert(pids.end(), bucket.begin(), bucket.end());
+        remaining &= remaining - 1;
+    }
+
+    return pids;
+}
+
+// Priority
+
+PriorityScheduler::PriorityScheduler(int cores) : BucketScheduler(cores, PRIORITY_LEVELS) {}
+
+int PriorityScheduler::level(int pid) const
+{
+    return getPriority(pid);
+}
+
+// MLFQ
+
+MLFQScheduler::MLFQScheduler(int cores) : BucketScheduler(cores, MLFQ_LEVELS) {}
+
+void MLFQScheduler::onEnqueue(int pid, ReadyReason reason)
+{
+    reservePid(levels_, pid, 0);
+
+    switch (reason)
+    {
+    case ReadyReason::EXPIRED:
+        levels_[pid] = std::min(levels_[pid] + 1, MLFQ_LEVELS - 1);
+        break;
+    case ReadyReason::CREATED:
+    case ReadyReason::WOKEN:
+        levels_[pid] = 0;
+        break;
+    case ReadyReason::PREEMPTED:
+        break;
+    }
+}
+
+int MLFQScheduler::level(int pid) const
+{
+    if (pid < 0 || static_cast<std::size_t>(pid) >= levels_.size())
+    {
+        return 0;
+    }
+
+    return levels_[pid];
+}
+
+// Fair
+
+FairScheduler::FairScheduler(int cores) : heaps_(cores), minRuntime_(cores, 0), arrivals_(0) {}
+
+/**
+ * @param a : process pid
+ * @param b : process pid
+ * @return : true if a runs before b
+ */
+bool FairScheduler::before(int a, int b) const
+{
+    return runtime_[a] < runtime_[b] || (runtime_[a] == runtime_[b] && arrival_[a] < arrival_[b]);
+}
+
+/**
+ * Puts a pid at a heap position and records it
+ * @param core : core index
+ * @param index : heap position
+ * @param pid : process pid
+ */
+void FairScheduler::place(int core, std::size_t index, int pid)
+{
+    heaps_[core][index] = pid;
+    heapIndex_[pid] = index;
+}
+
+/**
+ * Moves the pid at a heap position up or down until the heap is ordered again
+ * @param core : core index
+ * @param index : heap position
+ */
+void FairScheduler::sift(int core, std::size_t index)
+{
+    std::vector<int> &heap = heaps_[core];
+    int pid = heap[index];
+
+    while (index > 0 && before(pid, heap[(index - 1) / 2]))
+    {
+        place(core, index, heap[(index - 1) / 2]);
+        index = (index - 1) / 2;
+    }
+
+    while (2 * index + 1 < heap.size())
+    {
+        std::size_t child = 2 * index + 1;
+        if (child + 1 < heap.size() && before(heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if (!before(heap[child], pid))
+        {
+            break;
+        }
+        place(core, index, heap[child]);
+        index = child;
+    }
+
+    place(core, index, pid);
+}
+
+/**
+ * Removes the pid at a heap position and records how far it was past the core's minimum
+ * @param core : core index
+ * @param index : heap position
+ * @return : its pid
+ */
+int FairScheduler::take(int core, std::size_t index)
+{
+    std::vector<int> &heap = heaps_[core];
+    int pid = heap[index];
+
+    lag_[pid] = runtime_[pid] - minRuntime_[core];
+    heapCore_[pid] = -1;
+
+    int last = heap.back();
+    heap.pop_back();
+    if (index < heap.size())
+    {
+        place(core, index, last);
+        sift(core, index);
+    }
+
+    return pid;
+}
+
+void FairScheduler::enqueue(int pid, int core, ReadyReason reason)
+{
+    if (pid < 0)
+    {
+        return;
+    }
+
+    reservePid(runtime_, pid, 0LL);
+    reservePid(lag_, pid, 0LL);
+    reservePid(arrival_, pid, 0ULL);
+    reservePid(heapCore_, pid, -1);
+    reservePid(heapIndex_, pid, std::size_t(0));
+
+    remove(pid);
+
+    // runtimes only mean something next to the minimum of their own core
+    long long runtime = minRuntime_[core] + lag_[pid];
+    switch (reason)
+    {
+    case ReadyReason::CREATED:
+        runtime = minRuntime_[core];
+        break;
+    case ReadyReason::WOKEN:
+        // a sleeper gets a little ahead, but can't bank the time it was away
+        runtime = std::max(runtime, minRuntime_[core] - SLEEPER_CREDIT);
+        break;
+    case ReadyReason::EXPIRED:
+        runtime += TIME_SLICE * PRIORITY_WEIGHTS[DEFAULT_PRIORITY] / PRIORITY_WEIGHTS[getPriority(pid)];
+        break;
+    case ReadyReason::PREEMPTED:
+        break;
+    }
+
+    runtime_[pid] = runtime;
+    arrival_[pid] = ++arrivals_;
+    heapCore_[pid] = core;
+    heaps_[core].push_back(pid);
+    sift(core, heaps_[core].size() - 1);
+}
+
+int FairScheduler::pickNext(int core)
+{
+    if (heaps_[core].empty())
+    {
+        return NO_PROCESS;
+    }
+
+    minRuntime_[core] = std::max(minRuntime_[core], runtime_[heaps_[core].front()]);
+
+    return take(core, 0);
+}
+
+int FairScheduler::steal(int core)
+{
+    if (heaps_[core].empty())
+    {
+        return NO_PROCESS;
+    }
+
+    return take(core, heaps_[core].size() - 1);
+}
+
+void FairScheduler::remove(int pid)
+{
+    if (pid >= 0 && static_cast<std::size_t>(pid) < heapCore_.size() && heapCore_[pid] != -1)
+    {
+        take(heapCore_[pid], heapIndex_[pid]);
+    }
+}
+
+std::size_t FairScheduler::size(int core) const
+{
+    return heaps_[core].size();
+}
+
+std::deque<int> FairScheduler::toDeque(int core) const
+{
+    std::vector<int> pids(heaps_[core]);
+    std::sort(pids.begin(), pids.end(), [this](int a, int b)
+              { return before(a, b); });
+
+    return std::deque<int>(pids.begin(), pids.end());
+}
@@ -2,48 +2,129 @@
 // Raed Abuzaid
 
 #include "SimOS.h"
+#include <algorithm>
 #include <unordered_set>
 
+namespace
+{
+    constexpr unsigned long long NO_STAMP{~0ULL};
+
+    /**
+     * @param numberOfDisks : number of disks
+     * @param options : settings holding the default and per-disk models
+     * @return : the model of every disk
+     */
+    std::vector<DiskModel> diskModels(int numberOfDisks, const SimOSOptions &options)
+    {
+        std::vector<DiskModel> models(options.diskModels);
+        if (numberOfDisks > 0 && models.size() < static_cast<std::size_t>(numberOfDisks))
+        {
+            models.resize(numberOfDisks, options.diskModel);
+        }
+        return models;
+    }
+}
+
 /**
  * @param numberOfDisks : number of hard disks in the simulated computer.
  * @param amountOfRAM : amount of memory
  * @param pagesize : page size
+ * @param options : optional settings
  * @post : Creates a SimOS Object.
  */
-SimOS::SimOS(int numberOfDisks, unsigned long long amountOfRAM, unsigned int pageSize)
-    : processManager_(), diskManager_(numberOfDisks), memoryManager_(amountOfRAM, pageSize), cpu_()
+SimOS::SimOS(int numberOfDisks, unsigned long long amountOfRAM, unsigned int pageSize, SimOSOptions options)
+    : processManager_(),
+      diskManager_(numberOfDisks, options.diskScheduler, diskModels(numberOfDisks, options), options.seed),
+      memoryManager_(amountOfRAM, pageSize, options.replacementPolicy, options.tlbSets, options.tlbWays,
+                     std::max(options.cores, 1)),
+      cpu_(std::max(options.cores, 1), options.scheduler), now_(0), quantum_(options.quantum),
+      timerStamps_(std::max(options.cores, 1), NO_STAMP), diskStamps_(std::max(numberOfDisks, 0), 0)
 {
+    if (options.stackDistanceAnalysis)
+    {
+        memoryManager_.enableStackDistanceAnalysis();
+    }
+    if (options.copyOnWriteFork)
+    {
+        memoryManager_.enableCopyOnWriteFork();
+    }
+    if (options.prefetchDepth > 0)
+    {
+        memoryManager_.enablePrefetching(options.prefetchDepth, options.prefetchPressureDepth);
+    }
+    if (options.fileCacheCapacity > 0)
+    {
+        diskManager_.enableFileCache(options.fileCacheCapacity, options.fileCachePolicy);
+    }
+    if (options.coalesceDiskReads)
+    {
+        diskManager_.enableCoalescing();
+    }
+    if (!options.traceFile.empty())
+    {
+        TraceHeader header;
+        header.flags = options.compressTrace ? TRACE_COMPRESSED : 0;
+        header.disks = numberOfDisks;
+        header.amountOfRAM = amountOfRAM;
+        header.pageSize = pageSize;
+        header.options = options;
+        header.options.cores = std::max(options.cores, 1);
+        recorder_.reset(new TraceRecorder(options.traceFile, header));
+    }
+}
+
+/**
+ * @param core : core index
+ * @post : throws if the core does not exist
+ */
+void SimOS::checkCore(int core)
+{
+    if (core < 0 || core >= cpu_.getNumberOfCores())
+    {
+        throw std::logic_error("Requested core out of range.");
+    }
 }
 
 /**
- * @post : Creates a new process and adds it to the ready queue, or runs it if the cpu is idle.
+ * @post : Creates a new process and adds it to the ready queue of the least loaded core, or runs it if a core is idle.
  *         Every process in the simulated system has a PID.
  *         The sim assigns PIDs to new processes starting from 1 and increments it by one for each new process.
  *         PIDs are never recycled
  */
 void SimOS::NewProcess()
 {
-    int pid = processManager_.createProcess();
-    cpu_.addProcess(pid);
-
-    if (cpu_.getRunningProcess() == NO_PROCESS)
+    if (recorder_)
     {
-        cpu_.startProcess();
+        recorder_->recordCall(TraceOp::NEW_PROCESS, 0);
     }
+
+    int pid = processManager_.createProcess();
+    cpu_.addProcess(pid, ReadyReason::CREATED);
+    cpu_.startIdleCores();
 }
 
 /**
- * @post : The currently running process forks a child. The child is placed in the end of the ready-queue.
+ * @param core : core running the forking process.
+ * @post : The currently running process forks a child. The child is placed in the end of a ready-queue.
+ *         With copy-on-write fork the child shares the parent's resident pages.
  */
-void SimOS::SimFork()
+void SimOS::SimFork(int core)
 {
-    if (cpu_.getRunningProcess() == NO_PROCESS)
+    if (recorder_)
+    {
+        recorder_->recordCall(TraceOp::FORK, core);
+    }
+
+    checkCore(core);
+    if (cpu_.getRunningProcess(core) == NO_PROCESS)
     {
         throw std::logic_error("No process currently using the CPU.");
     }
 
-    int childPID = processManager_.forkProcess(cpu_.getRunningProcess());
-    cpu_.addProcess(childPID);
+    int childPID = processManager_.forkProcess(cpu_.getRunningProcess(core));
+    memoryManager_.forkMemory(cpu_.getRunningProcess(core), childPID);
+    cpu_.addProcess(childPID, ReadyReason::CREATED);
+    cpu_.startIdleCores();
 }
 
 /**
@@ -52,19 +133,27 @@ void SimOS::SimFork()
  *         If its parent is already waiting, the process terminates immediately and the parent becomes runnable (goes to the ready-queue).
  *         If its parent hasn't called wait yet, the process turns into zombie.
  *         To avoid the appearance of orphans, the system implements cascading termination.
+ * @param core : core running the exiting process.
  */
-void SimOS::SimExit()
+void SimOS::SimExit(int core)
 {
-    if (cpu_.getRunningProcess() == NO_PROCESS)
+    if (recorder_)
+    {
+        recorder_->recordCall(TraceOp::EXIT, core);
+    }
+
+    checkCore(core);
+    if (cpu_.getRunningProcess(core) == NO_PROCESS)
     {
         throw std::logic_error("No process currently using the CPU.");
     }
 
-    int pid = cpu_.getRunningProcess();
-    cpu_.removeRunningProcess();
+    int pid = cpu_.getRunningProcess(core);
+    cpu_.removeRunningProcess(core);
     processManager_.terminateProcess(pid, cpu_, memoryManager_, diskManager_);
 
-    cpu_.startProcess();
+    // descendants running on other cores may have left too
+    cpu_.startIdleCores();
 }
 
 /**
@@ -72,115 +161,235 @@ void SimOS::SimExit()
  *         Once the wait is over, the process goes to the end of the ready-queue or the CPU.
  *         If the zombie-child already exists, the process proceeds right away (keeps using the CPU) and the zombie-child disappears.
  *         If more than one zombie-child exists, the system uses one of them (any!) to immediately resume the parent, while other zombies keep waiting for the next wait from the parent.
+ * @param core : core running the waiting process.
  */
-void SimOS::SimWait()
+void SimOS::SimWait(int core)
 {
-    if (cpu_.getRunningProcess() == NO_PROCESS)
+    if (recorder_)
     {
-        throw std::logic_error("No process currently using the CPU.");
+        recorder_->recordCall(TraceOp::WAIT, core);
     }
 
-    processManager_.waitProcess(cpu_.getRunningProcess(), cpu_);
-
-    if (cpu_.getRunningProcess() == NO_PROCESS)
+    checkCore(core);
+    if (cpu_.getRunningProcess(core) == NO_PROCESS)
     {
-        cpu_.startProcess();
+        throw std::logic_error("No process currently using the CPU.");
     }
+
+    processManager_.waitProcess(cpu_.getRunningProcess(core), cpu_);
+    cpu_.startIdleCores();
 }
 
 /**
- * @post : Interrupt arrives from the timer signaling that the time slice of the currently running process is over.
+ * @param core : core whose timer fired.
+ * @post : Interrupt arrives from the timer signaling that the time slice of the process running on the core is over.
  */
-void SimOS::TimerInterrupt()
+void SimOS::TimerInterrupt(int core)
 {
-    if (cpu_.getRunningProcess() == NO_PROCESS)
+    if (recorder_)
+    {
+        recorder_->recordCall(TraceOp::TIMER, core);
+    }
+
+    checkCore(core);
+    if (cpu_.getRunningProcess(core) == NO_PROCESS)
     {
         throw std::logic_error("No process currently using the CPU.");
     }
 
-    cpu_.handleTimerInterrupt();
+    cpu_.handleTimerInterrupt(core);
 }
 
 /**
  * @param diskNumber : the number of the disk to read from.
  * @param fileName : the name of the file to read.
+ * @param core : core running the reading process.
  * @post : Currently running process requests to read the specified file from the disk with a given number.
  *         The process issuing disk reading requests immediately stops using the CPU, even if the ready-queue is empty.
+ *         If the file cache holds the file, the process goes back to the ready-queue instead of waiting for the disk.
  */
-void SimOS::DiskReadRequest(int diskNumber, std::string fileName)
+void SimOS::DiskReadRequest(int diskNumber, const std::string &fileName, int core)
 {
-    if (cpu_.getRunningProcess() == NO_PROCESS)
+    if (recorder_)
+    {
+        recorder_->recordDiskRead(core, diskNumber, fileName);
+    }
+
+    checkCore(core);
+    if (cpu_.getRunningProcess(core) == NO_PROCESS)
     {
         throw std::logic_error("No process currently using the CPU.");
     }
-    if (diskNumber > diskManager_.getNumberOfDisks() - 1)
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
     {
         throw std::logic_error("Requested disk out of range.");
     }
 
-    diskManager_.readRequest(cpu_.getRunningProcess(), diskNumber, fileName);
-    cpu_.removeRunningProcess();
+    int pid = cpu_.getRunningProcess(core);
+    bool cached = diskManager_.readRequest(pid, diskNumber, fileName);
+    cpu_.removeRunningProcess(core);
+
+    // a cached file is read without waiting, back in line right away
+    if (cached)
+    {
+        cpu_.addProcess(pid, ReadyReason::WOKEN);
+    }
 
     // start new
-    cpu_.startProcess();
+    cpu_.startIdleCores();
 }
 
 /**
  * @param diskNumber : the number of the disk that completed a job.
- * @post : A disk with a specified number reports that a single job is completed.
- *         The served process should return to the ready-queue.
+ * @post : A disk with a specified number reports that a single job is completed, the oldest one if it serves several.
+ *         The served process should return to the ready-queue, with every process whose read was coalesced into it, in the order they asked.
  */
 void SimOS::DiskJobCompleted(int diskNumber)
 {
-    if (diskNumber > diskManager_.getNumberOfDisks() - 1)
+    if (recorder_)
+    {
+        recorder_->recordDiskDone(diskNumber);
+    }
+
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
     {
         throw std::logic_error("Requested disk out of range.");
     }
 
-    if (diskManager_.getDiskStatus(diskNumber).PID != 0)
+    wakeProcesses(diskManager_.completeJob(diskNumber));
+}
+
+/**
+ * @param diskNumber : the number of the disk that completed a job.
+ * @param slot : the slot of the job, below the queue depth of the disk.
+ * @post : The job in that slot is completed, nothing happens if the slot is free.
+ *         The served process should return to the ready-queue, with every process whose read was coalesced into it, in the order they asked.
+ */
+void SimOS::DiskJobCompleted(int diskNumber, int slot)
+{
+    if (recorder_)
     {
-        int pid = diskManager_.completeJob(diskNumber);
-        cpu_.addProcess(pid);
+        recorder_->recordDiskDone(diskNumber, slot);
+    }
 
-        if (cpu_.getRunningProcess() == NO_PROCESS)
-        {
-            cpu_.startProcess();
-        }
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
+    {
+        throw std::logic_error("Requested disk out of range.");
+    }
+    if (slot < 0 || slot > diskManager_.getQueueDepth(diskNumber) - 1)
+    {
+        throw std::logic_error("Requested slot out of range.");
     }
+
+    wakeProcesses(diskManager_.completeJob(diskNumber, slot));
 }
 
 /**
  * @param address : the logical memory address to access.
+ * @param write : true if the process writes the address.
+ * @param core : core running the process, its TLB is used.
  * @post : Currently running process wants to access the specified logical memory address.
  *         System makes sure the corresponding page is loaded in the RAM.
  *         If the corresponding page is already in the RAM, its “recently used” information is updated.
  */
-void SimOS::AccessMemoryAddress(unsigned long long address)
+void SimOS::AccessMemoryAddress(unsigned long long address, bool write, int core)
+{
+    if (recorder_)
+    {
+        recorder_->recordAccess(core, address, write);
+    }
+
+    checkCore(core);
+    memoryManager_.accessAddress(cpu_.getRunningProcess(core), address, write, core);
+}
+
+/**
+ * @param addresses : the logical memory addresses to access.
+ * @param count : number of addresses.
+ * @param write : true if the process writes the addresses.
+ * @param core : core running the process, its TLB is used.
+ * @post : Currently running process accesses a sequence of logical memory addresses, in order.
+ *         Same result as calling AccessMemoryAddress on each address.
+ */
+void SimOS::AccessMemoryAddresses(const unsigned long long *addresses, std::size_t count, bool write, int core)
+{
+    if (recorder_)
+    {
+        recorder_->recordAccesses(core, addresses, count, write);
+    }
+
+    checkCore(core);
+    memoryManager_.accessAddresses(cpu_.getRunningProcess(core), addresses, count, write, core);
+}
+
+/**
+ * @param addresses : the logical memory addresses to access, in order.
+ * @param write : true if the process writes the addresses.
+ * @param core : core running the process, its TLB is used.
+ * @post : Currently running process accesses every address, same result as calling AccessMemoryAddress on each.
+ */
+void SimOS::AccessMemoryAddresses(const std::vector<unsigned long long> &addresses, bool write, int core)
 {
-    memoryManager_.accessAddress(cpu_.getRunningProcess(), address);
+    AccessMemoryAddresses(addresses.data(), addresses.size(), write, core);
 }
 
 /**
- * @return : GetCPU returns the PID of the process currently using the CPU.
- *           If CPU is idle it returns NO_PROCESS.
+ * @param core : core to query.
+ * @return : GetCPU returns the PID of the process currently using the core.
+ *           If the core is idle it returns NO_PROCESS.
  */
-int SimOS::GetCPU()
+int SimOS::GetCPU(int core)
 {
-    return cpu_.getRunningProcess();
+    checkCore(core);
+    return cpu_.getRunningProcess(core);
+}
+
+/**
+ * @param core : core to query.
+ * @return : GetReadyQueue returns the std::deque with PIDs of processes in the ready-queue of the core, in the order the scheduler would run them.
+ */
+std::deque<int> SimOS::GetReadyQueue(int core)
+{
+    checkCore(core);
+    return cpu_.getReadyQueue(core);
+}
+
+/**
+ * @param pid : process to change.
+ * @param priority : 0 is the highest, PRIORITY_LEVELS - 1 the lowest.
+ * @post : The priority and fair schedulers use the new priority from the next scheduling decision on,
+ *         round robin and MLFQ ignore it.
+ */
+void SimOS::SetPriority(int pid, int priority)
+{
+    if (recorder_)
+    {
+        recorder_->recordPriority(pid, priority);
+    }
+
+    if (priority < 0 || priority >= PRIORITY_LEVELS)
+    {
+        throw std::logic_error("Priority out of range.");
+    }
+
+    cpu_.setPriority(pid, priority);
 }
 
 /**
- * @return : GetReadyQueue returns the std::deque with PIDs of processes in the ready-queue where element in front corresponds start of the ready-queue.
+ * @param core : core to query.
+ * @return : processes the core took from other cores' queues and processes it ran after they last ran elsewhere.
  */
-std::deque<int> SimOS::GetReadyQueue()
+CoreStats SimOS::GetCoreStats(int core)
 {
-    return cpu_.getReadyQueue();
+    checkCore(core);
+    return cpu_.getCoreStats(core);
 }
 
 /**
  * @return : GetMemory returns MemoryUsage vector describing all currently used frames of RAM.
  *           Terminated “zombie” processes don’t use memory, so they don’t contribute to memory usage.
  *           MemoryItems appear in the MemoryUsage vector in the order they appear in memory (from low addresses to high).
+ *           A frame shared by copy-on-write fork appears once for every process mapping it.
  */
 MemoryUsage SimOS::GetMemory()
 {
@@ -189,31 +398,346 @@ MemoryUsage SimOS::GetMemory()
 
 /**
  * @param diskNumber : the number of the disk to query.
- * @return : GetDisk returns an object with PID of the process served by specified disk and the name of the file read for that process.
+ * @return : GetDisk returns an object with PID of the process served by specified disk and the name of the file read for that process,
+ *           the oldest one if the disk serves several.
  *           If the disk is idle, GetDisk returns the default FileReadRequest object (with PID 0 and empty string in fileName).
  */
 FileReadRequest SimOS::GetDisk(int diskNumber)
 {
-    if (diskNumber > diskManager_.getNumberOfDisks() - 1)
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
     {
         throw std::logic_error("Requested disk out of range.");
     }
 
-    FileReadRequest request(diskManager_.getDiskStatus(diskNumber));
+    return diskManager_.getDiskStatus(diskNumber);
+}
+
+/**
+ * @param diskNumber : the number of the disk to query.
+ * @return : the request served in every slot of the disk, indexed by slot, PID 0 and empty fileName for free slots.
+ */
+std::vector<FileReadRequest> SimOS::GetDiskSlots(int diskNumber)
+{
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
+    {
+        throw std::logic_error("Requested disk out of range.");
+    }
 
-    return request;
+    std::vector<FileReadRequest> slots;
+    for (int slot = 0; slot < diskManager_.getQueueDepth(diskNumber); slot++)
+    {
+        slots.push_back(diskManager_.getDiskStatus(diskNumber, slot));
+    }
+
+    return slots;
 }
 
 /**
  * @param diskNumber : the number of the disk to query.
- * @return : GetDiskQueue returns the I/O-queue of the specified disk starting from the “next to be served” process.
+ * @return : GetDiskQueue returns the I/O-queue of the specified disk starting from the “next to be served” process,
+ *           in the order the disk's head scheduler would serve it if nothing else arrived.
+ *           Processes whose reads were coalesced into the one being served come first.
  */
 std::deque<FileReadRequest> SimOS::GetDiskQueue(int diskNumber)
 {
-    if (diskNumber > diskManager_.getNumberOfDisks() - 1)
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
     {
         throw std::logic_error("Requested disk out of range.");
     }
 
     return diskManager_.getDiskQueue(diskNumber);
-}
\ No newline at end of file
+}
+
+/**
+ * @param diskNumber : the number of the disk to configure.
+ * @param scheduler : head scheduling policy.
+ * @post : The disk serves its waiting and future requests with the new policy.
+ */
+void SimOS::SetDiskScheduler(int diskNumber, DiskSchedulerType scheduler)
+{
+    if (recorder_)
+    {
+        recorder_->recordDiskScheduler(diskNumber, scheduler);
+    }
+
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
+    {
+        throw std::logic_error("Requested disk out of range.");
+    }
+
+    diskManager_.setScheduler(diskNumber, scheduler);
+}
+
+/**
+ * @param diskNumber : the number of the disk holding the file.
+ * @param fileName : the name of the file.
+ * @param block : block the file starts at, below SimOSOptions::diskModel.blocks.
+ * @post : Later reads of the file from that disk seek to the block.
+ */
+void SimOS::PlaceFile(int diskNumber, const std::string &fileName, unsigned long long block)
+{
+    if (recorder_)
+    {
+        recorder_->recordPlaceFile(diskNumber, fileName, block);
+    }
+
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
+    {
+        throw std::logic_error("Requested disk out of range.");
+    }
+    if (block >= diskManager_.getDiskModel(diskNumber).blocks)
+    {
+        throw std::logic_error("Requested block out of range.");
+    }
+
+    diskManager_.placeFile(diskNumber, fileName, block);
+}
+
+/**
+ * @param diskNumber : the number of the disk to query.
+ * @return : requests served, blocks travelled by the head and summed request latency of the disk.
+ *           Average latency is totalLatency / served.
+ */
+DiskStats SimOS::GetDiskStats(int diskNumber)
+{
+    if (diskNumber < 0 || diskNumber > diskManager_.getNumberOfDisks() - 1)
+    {
+        throw std::logic_error("Requested disk out of range.");
+    }
+
+    return diskManager_.getDiskStats(diskNumber);
+}
+
+/**
+ * @return : reads served from the file cache, reads that went to a disk and cached files dropped.
+ */
+FileCacheStats SimOS::GetFileCacheStats()
+{
+    return diskManager_.getFileCacheStats();
+}
+
+/**
+ * @return : hit, miss and eviction counters of the page replacement policy.
+ */
+ReplacementStats SimOS::GetReplacementStats()
+{
+    return memoryManager_.getReplacementStats();
+}
+
+/**
+ * @return : hit, miss and invalidation counters of the TLB.
+ */
+TLBStats SimOS::GetTLBStats()
+{
+    return memoryManager_.getTLBStats();
+}
+
+/**
+ * @return : pages shared by copy-on-write fork and copies made when a sharer wrote one.
+ */
+CopyOnWriteStats SimOS::GetCopyOnWriteStats()
+{
+    return memoryManager_.getCopyOnWriteStats();
+}
+
+/**
+ * @return : pages prefetched, later used, evicted unused and held back under memory pressure.
+ *           Accuracy is useful / issued, coverage is useful / (useful + GetReplacementStats().misses).
+ */
+PrefetchStats SimOS::GetPrefetchStats()
+{
+    return memoryManager_.getPrefetchStats();
+}
+
+/**
+ * @param maxFrames : largest RAM size, in frames, to report.
+ * @return : LRU miss ratio of every access so far with 0, 1, ..., maxFrames frames of RAM, empty if analysis is off.
+ */
+std::vector<double> SimOS::GetMissRatioCurve(unsigned long long maxFrames)
+{
+    const StackDistanceAnalyzer *analyzer = memoryManager_.getStackDistanceAnalyzer();
+
+    return analyzer == nullptr ? std::vector<double>() : analyzer->missRatioCurve(maxFrames);
+}
+
+/**
+ * @param pid : process to report.
+ * @param maxFrames : largest RAM size, in frames, to report.
+ * @return : LRU miss ratio of the process with 0, 1, ..., maxFrames frames of RAM to itself, empty if analysis is off.
+ */
+std::vector<double> SimOS::GetProcessMissRatioCurve(int pid, unsigned long long maxFrames)
+{
+    const StackDistanceAnalyzer *analyzer = memoryManager_.getStackDistanceAnalyzer();
+
+    return analyzer == nullptr ? std::vector<double>() : analyzer->missRatioCurve(pid, maxFrames);
+}
+
+/**
+ * Returns processes a disk served to the ready-queue and fills idle cores
+ * @param pids : processes in the order they asked
+ */
+void SimOS::wakeProcesses(const std::vector<int> &pids)
+{
+    if (pids.empty())
+    {
+        return;
+    }
+
+    for (int pid : pids)
+    {
+        cpu_.addProcess(pid, ReadyReason::WOKEN);
+    }
+    cpu_.startIdleCores();
+}
+
+/**
+ * Schedules a timer interrupt for every core that started a process, and a completion for every disk that
+ * started a request, since the last call
+ */
+void SimOS::scheduleEvents()
+{
+    if (quantum_ > 0)
+    {
+        for (int core = 0; core < cpu_.getNumberOfCores(); core++)
+        {
+            unsigned long long dispatches = cpu_.getCoreStats(core).dispatches;
+            if (cpu_.getRunningProcess(core) != NO_PROCESS && timerStamps_[core] != dispatches)
+            {
+                events_.push(now_ + quantum_, EventType::TIMER, core, 0, dispatches);
+                timerStamps_[core] = dispatches;
+            }
+        }
+    }
+
+    for (int disk = 0; disk < diskManager_.getNumberOfDisks(); disk++)
+    {
+        unsigned long long started = diskManager_.getDiskStats(disk).started;
+        if (diskStamps_[disk] == started)
+        {
+            continue;
+        }
+
+        // slots only need a look when the disk started something
+        for (int slot = 0; slot < diskManager_.getQueueDepth(disk); slot++)
+        {
+            const DiskSlot &inFlight = diskManager_.getSlot(disk, slot);
+            if (inFlight.serving.PID != 0 && inFlight.operation > diskStamps_[disk])
+            {
+                events_.push(inFlight.finishTime, EventType::DISK_DONE, disk, slot, inFlight.operation);
+            }
+        }
+        diskStamps_[disk] = started;
+    }
+}
+
+/**
+ * Carries out an event, unless what it was scheduled for has changed since
+ * @param event : the event
+ * @return : true if the event was still current
+ */
+bool SimOS::handleEvent(const Event &event)
+{
+    switch (event.type)
+    {
+    case EventType::TIMER:
+        // stale once the core has started another process
+        if (cpu_.getCoreStats(event.target).dispatches != event.stamp ||
+            cpu_.getRunningProcess(event.target) == NO_PROCESS)
+        {
+            return false;
+        }
+        TimerInterrupt(event.target);
+        timerStamps_[event.target] = NO_STAMP; // a process kept running gets a fresh quantum
+        return true;
+
+    case EventType::DISK_DONE:
+    {
+        // stale once the request was cancelled and the slot moved on
+        const DiskSlot &inFlight = diskManager_.getSlot(event.target, event.slot);
+        if (inFlight.operation != event.stamp || inFlight.serving.PID == 0)
+        {
+            return false;
+        }
+        DiskJobCompleted(event.target, event.slot);
+        return true;
+    }
+
+    case EventType::ACTION:
+    default:
+    {
+        std::function<void(SimOS &)> action(std::move(actions_[event.target]));
+        actions_[event.target] = nullptr;
+        freeActions_.push_back(event.target);
+        action(*this);
+        return true;
+    }
+    }
+}
+
+/**
+ * @param time : virtual time to stop at, not before GetTime().
+ * @return : number of events handled.
+ */
+unsigned long long SimOS::RunUntil(unsigned long long time)
+{
+    if (time < now_)
+    {
+        throw std::logic_error("Requested time already passed.");
+    }
+
+    unsigned long long handled = 0;
+    scheduleEvents();
+
+    while (!events_.empty() && events_.top().time <= time)
+    {
+        Event event = events_.pop();
+        now_ = event.time;
+        diskManager_.advanceClock(now_);
+
+        if (handleEvent(event))
+        {
+            handled++;
+            scheduleEvents();
+        }
+    }
+
+    now_ = time;
+    diskManager_.advanceClock(now_);
+
+    return handled;
+}
+
+/**
+ * @param time : virtual time to run the action at, not before GetTime().
+ * @param action : called with this SimOS when due, it may make any call, ScheduleAction included.
+ * @post : The action runs during the RunUntil call that reaches its time.
+ */
+void SimOS::ScheduleAction(unsigned long long time, std::function<void(SimOS &)> action)
+{
+    if (time < now_)
+    {
+        throw std::logic_error("Requested time already passed.");
+    }
+
+    int id = static_cast<int>(actions_.size());
+    if (!freeActions_.empty())
+    {
+        id = freeActions_.back();
+        freeActions_.pop_back();
+        actions_[id] = std::move(action);
+    }
+    else
+    {
+        actions_.push_back(std::move(action));
+    }
+
+    events_.push(time, EventType::ACTION, id, 0, 0);
+}
+
+/**
+ * @return : current virtual time.
+ */
+unsigned long long SimOS::GetTime()
+{
+    return now_;
+}
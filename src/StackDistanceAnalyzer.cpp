@@ -0,0 +1,207 @@
+// Raed Abuzaid
+
+#include "StackDistanceAnalyzer.hpp"
+#include <algorithm>
+
+namespace
+{
+    constexpr unsigned long long COMPACT_SLACK{1 << 16}; // stale times tolerated before renumbering
+
+    /**
+     * @param marks : Fenwick tree
+     * @param time : last time to include
+     * @return : number of marks at times 1..time
+     */
+    unsigned long long prefix(const std::vector<unsigned int> &marks, unsigned long long time)
+    {
+        unsigned long long sum = 0;
+        for (; time > 0; time -= time & (~time + 1))
+        {
+            sum += marks[time];
+        }
+        return sum;
+    }
+
+    /**
+     * Clears the mark at a time
+     * @param marks : Fenwick tree
+     * @param time : marked time
+     */
+    void unmark(std::vector<unsigned int> &marks, unsigned long long time)
+    {
+        for (; time < marks.size(); time += time & (~time + 1))
+        {
+            marks[time]--;
+        }
+    }
+
+    /**
+     * Appends the next time to the tree with a mark on it
+     * @param marks : Fenwick tree
+     */
+    void appendMark(std::vector<unsigned int> &marks)
+    {
+        unsigned long long time = marks.size();
+        unsigned long long covered = time & (~time + 1);
+
+        // the new node covers (time - covered, time], which the tree already knows up to time - 1
+        marks.push_back(static_cast<unsigned int>(1 + prefix(marks, time - 1) - prefix(marks, time - covered)));
+    }
+}
+
+/**
+ * @param pageSize : page size used to turn addresses into pages
+ */
+StackDistanceAnalyzer::StackDistanceAnalyzer(unsigned int pageSize) : pageSize_(pageSize) {}
+
+/**
+ * Records an access on one stack
+ * @param stack : stack to update
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void StackDistanceAnalyzer::record(Stack &stack, int pid, unsigned long long pageNumber)
+{
+    stack.accesses++;
+    unsigned long long now = ++stack.time;
+
+    const unsigned long long *last = stack.lastAccess.find(pid, pageNumber);
+    if (last != nullptr)
+    {
+        // distinct pages touched since the previous access to this one
+        unsigned long long distance = prefix(stack.marks, now - 1) - prefix(stack.marks, *last);
+        if (distance >= stack.distances.size())
+        {
+            stack.distances.resize(distance + 1, 0);
+        }
+        stack.distances[distance]++;
+
+        unmark(stack.marks, *last);
+    }
+    else
+    {
+        stack.coldMisses++;
+        stack.distinctPages++;
+    }
+
+    appendMark(stack.marks);
+    stack.lastAccess.insert(pid, pageNumber, now);
+
+    if (stack.time > 2 * stack.distinctPages + COMPACT_SLACK)
+    {
+        compact(stack);
+    }
+}
+
+/**
+ * Renumbers the marked access times 1..distinctPages so the tree stays proportional to the pages
+ * @param stack : stack to compact
+ */
+void StackDistanceAnalyzer::compact(Stack &stack)
+{
+    std::vector<unsigned long long *> times;
+    times.reserve(stack.distinctPages);
+    stack.lastAccess.forEach([&times](int, unsigned long long, unsigned long long &time)
+                             { times.push_back(&time); });
+
+    std::sort(times.begin(), times.end(), [](const unsigned long long *a, const unsigned long long *b)
+              { return *a < *b; });
+
+    // every remaining time is marked, and a node of an all-ones tree holds its own range length
+    stack.marks.assign(times.size() + 1, 0);
+    for (unsigned long long time = 1; time <= times.size(); time++)
+    {
+        *times[time - 1] = time;
+        stack.marks[time] = static_cast<unsigned int>(time & (~time + 1));
+    }
+    stack.time = times.size();
+}
+
+/**
+ * @param stack : stack to read
+ * @param maxFrames : largest RAM size, in frames, to report
+ * @return : miss ratio for every RAM size from 0 to maxFrames frames
+ */
+std::vector<double> StackDistanceAnalyzer::curve(const Stack &stack, unsigned long long maxFrames)
+{
+    std::vector<double> ratios(maxFrames + 1, 0.0);
+    if (stack.accesses == 0)
+    {
+        return ratios;
+    }
+
+    // with c frames an access misses if it is cold or its distance is at least c
+    unsigned long long misses = stack.accesses;
+    for (unsigned long long frames = 0; frames <= maxFrames; frames++)
+    {
+        ratios[frames] = static_cast<double>(misses) / stack.accesses;
+        if (frames < stack.distances.size())
+        {
+            misses -= stack.distances[frames];
+        }
+    }
+
+    return ratios;
+}
+
+/**
+ * Records an access by address
+ * @param pid : process pid
+ * @param address : process logical address
+ */
+void StackDistanceAnalyzer::accessAddress(int pid, unsigned long long address)
+{
+    accessPage(pid, address / pageSize_);
+}
+
+/**
+ * Records an access by page number
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void StackDistanceAnalyzer::accessPage(int pid, unsigned long long pageNumber)
+{
+    record(global_, pid, pageNumber);
+    record(processes_[pid], pid, pageNumber);
+}
+
+/**
+ * @param maxFrames : largest RAM size, in frames, to report
+ * @return : global LRU miss ratio with 0, 1, ..., maxFrames frames of RAM
+ */
+std::vector<double> StackDistanceAnalyzer::missRatioCurve(unsigned long long maxFrames) const
+{
+    return curve(global_, maxFrames);
+}
+
+/**
+ * @param pid : process pid
+ * @param maxFrames : largest RAM size, in frames, to report
+ * @return : LRU miss ratio of the process alone with 0, 1, ..., maxFrames frames, empty if it never accessed memory
+ */
+std::vector<double> StackDistanceAnalyzer::missRatioCurve(int pid, unsigned long long maxFrames) const
+{
+    auto process = processes_.find(pid);
+    if (process == processes_.end())
+    {
+        return std::vector<double>();
+    }
+
+    return curve(process->second, maxFrames);
+}
+
+/**
+ * @return : number of frames past which the global miss ratio stops improving
+ */
+unsigned long long StackDistanceAnalyzer::maxUsefulFrames() const
+{
+    return global_.distances.size();
+}
+
+/**
+ * @return : number of recorded accesses
+ */
+unsigned long long StackDistanceAnalyzer::accesses() const
+{
+    return global_.accesses;
+}
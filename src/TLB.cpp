@@ -0,0 +1,160 @@
+// Raed Abuzaid
+
+#include "TLB.hpp"
+
+/**
+ * Creates an empty TLB, a TLB with no entries never hits and counts nothing
+ * @param sets : number of sets, rounded down to a power of two
+ * @param ways : entries per set
+ */
+TLB::TLB(unsigned int sets, unsigned int ways) : setMask_(0), ways_(ways), clock_(0)
+{
+    unsigned long long setCount = 1;
+    while (setCount * 2 <= sets)
+    {
+        setCount *= 2;
+    }
+
+    if (sets == 0 || ways == 0)
+    {
+        ways_ = 0;
+    }
+    else
+    {
+        setMask_ = setCount - 1;
+        entries_.resize(setCount * ways);
+    }
+}
+
+/**
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @return : first entry of the set the page maps to
+ */
+TLB::Entry *TLB::set(int pid, unsigned long long pageNumber)
+{
+    unsigned long long h = (pageNumber ^ (static_cast<unsigned long long>(pid) * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+
+    return &entries_[((h >> 32) & setMask_) * ways_];
+}
+
+/**
+ * Looks up a translation, counting a hit or a miss
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @param frameNumber : set to the cached frame on a hit
+ * @return : true on a hit
+ */
+bool TLB::lookup(int pid, unsigned long long pageNumber, unsigned long long &frameNumber)
+{
+    if (ways_ == 0)
+    {
+        return false;
+    }
+
+    Entry *entry = set(pid, pageNumber);
+    for (unsigned int way = 0; way < ways_; way++, entry++)
+    {
+        if (entry->lastUse != 0 && entry->pageNumber == pageNumber && entry->PID == pid)
+        {
+            entry->lastUse = ++clock_;
+            frameNumber = entry->frameNumber;
+            stats_.hits++;
+            return true;
+        }
+    }
+
+    stats_.misses++;
+    return false;
+}
+
+/**
+ * Counts hits on a translation that was just looked up, for repeated accesses to one page
+ * @param count : number of hits
+ */
+void TLB::recordHits(unsigned long long count)
+{
+    if (ways_ != 0)
+    {
+        stats_.hits += count;
+    }
+}
+
+/**
+ * Caches a translation, replacing the least recently used way of its set
+ * @param pid : process pid
+ * @param pageNumber : page number
+ * @param frameNumber : frame number
+ */
+void TLB::insert(int pid, unsigned long long pageNumber, unsigned long long frameNumber)
+{
+    if (ways_ == 0)
+    {
+        return;
+    }
+
+    // invalid entries have the oldest stamp, so they are picked first
+    Entry *entry = set(pid, pageNumber);
+    Entry *victim = entry;
+    for (unsigned int way = 1; way < ways_; way++)
+    {
+        if (entry[way].lastUse < victim->lastUse)
+        {
+            victim = &entry[way];
+        }
+    }
+
+    victim->PID = pid;
+    victim->pageNumber = pageNumber;
+    victim->frameNumber = frameNumber;
+    victim->lastUse = ++clock_;
+}
+
+/**
+ * Drops the translation of a page if it is cached
+ * @param pid : process pid
+ * @param pageNumber : page number
+ */
+void TLB::invalidate(int pid, unsigned long long pageNumber)
+{
+    if (ways_ == 0)
+    {
+        return;
+    }
+
+    Entry *entry = set(pid, pageNumber);
+    for (unsigned int way = 0; way < ways_; way++, entry++)
+    {
+        if (entry->lastUse != 0 && entry->pageNumber == pageNumber && entry->PID == pid)
+        {
+            entry->lastUse = 0;
+            stats_.invalidations++;
+            return;
+        }
+    }
+}
+
+/**
+ * Drops every translation of a set of processes in one pass
+ * @param pids : true at the index of every process to drop
+ */
+void TLB::invalidateProcesses(const std::vector<bool> &pids)
+{
+    for (Entry &entry : entries_)
+    {
+        if (entry.lastUse != 0 && entry.PID >= 0 && static_cast<std::size_t>(entry.PID) < pids.size() &&
+            pids[entry.PID])
+        {
+            entry.lastUse = 0;
+            stats_.invalidations++;
+        }
+    }
+}
+
+/**
+ * @return : hit, miss and invalidation counters
+ */
+const TLBStats &TLB::stats() const
+{
+    return stats_;
+}
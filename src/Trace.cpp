@@ -0,0 +1,1198 @@
+// Raed Abuzaid
+
+#include "Trace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr int HASH_BITS{14};        // positions remembered while compressing a block
+    constexpr std::size_t MIN_MATCH{4};
+    constexpr std::size_t MAX_OFFSET{65535};
+    constexpr std::size_t LAST_LITERALS{5}; // a block always ends with literals
+    constexpr int SKIP_STRENGTH{6};         // without matches the search steps further every 64 bytes
+    constexpr std::size_t NO_RUN{~std::size_t(0)};
+    constexpr std::size_t MAX_VARINT_BYTES{10};    // a 64 bit varint
+    constexpr unsigned char STREAK_TAG{0};         // a streak of accesses, its length less one in the next byte
+    constexpr unsigned char WIDE_TAGS{8};          // tags up to 8 count the bytes after them, larger ones hold
+                                                   // the difference plus 8
+    constexpr std::size_t MAX_STREAK_BYTES{2};     // tag and length
+    constexpr std::size_t MAX_DIFFERENCE_BYTES{9}; // tag and a whole 64 bit difference
+    constexpr int MIN_SAVING_SHIFT{3};             // a block compressed by less than an eighth is not worth it
+    constexpr unsigned int MAX_RAW_STRETCH{32};    // most blocks kept raw untried after one that was not
+
+    /**
+     * @param value : value to encode
+     * @param out : room for 10 bytes
+     * @return : first byte after the varint
+     */
+    unsigned char *putVarint(unsigned long long value, unsigned char *out)
+    {
+        while (value >= 0x80)
+        {
+            *out++ = static_cast<unsigned char>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<unsigned char>(value);
+        return out;
+    }
+
+    /**
+     * @param in : first byte of the varint
+     * @param end : end of the bytes available
+     * @param value : set to the decoded value
+     * @return : first byte after the varint
+     */
+    const unsigned char *getVarint(const unsigned char *in, const unsigned char *end, unsigned long long &value)
+    {
+        if (in < end && *in < 0x80) // most arguments are small
+        {
+            value = *in;
+            return in + 1;
+        }
+
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (in == end)
+            {
+                throw std::runtime_error("Trace ends inside a call.");
+            }
+
+            unsigned char byte = *in++;
+            value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if (byte < 0x80)
+            {
+                return in;
+            }
+        }
+
+        throw std::runtime_error("Trace holds a varint longer than 64 bits.");
+    }
+
+    /**
+     * @param in : first byte of the varint
+     * @param end : end of the bytes available
+     * @param value : set to the decoded value
+     * @return : first byte after the varint
+     */
+    const unsigned char *getInt(const unsigned char *in, const unsigned char *end, int &value)
+    {
+        unsigned long long decoded;
+        in = getVarint(in, end, decoded);
+        value = static_cast<int>(decoded);
+        return in;
+    }
+
+    /**
+     * @param from : previous address
+     * @param to : next address
+     * @return : the signed difference, zigzag encoded so small steps either way stay small
+     */
+    unsigned long long zigzag(unsigned long long from, unsigned long long to)
+    {
+        unsigned long long difference = to - from;
+        return difference << 1 ^ (0 - (difference >> 63));
+    }
+
+    /**
+     * @param from : previous address
+     * @param zigzagged : difference as zigzag returns it
+     * @return : next address
+     */
+    unsigned long long unzigzag(unsigned long long from, unsigned long long zigzagged)
+    {
+        return from + (zigzagged >> 1 ^ (0 - (zigzagged & 1)));
+    }
+
+    /**
+     * Writes a difference between an access and its prediction, in the tag byte if it is small
+     * @param value : zigzagged difference, not 0
+     * @param out : room for MAX_DIFFERENCE_BYTES bytes, all of them may be overwritten
+     * @return : first byte after the difference
+     */
+    unsigned char *putDifference(unsigned long long value, unsigned char *out)
+    {
+        if (value < 256 - WIDE_TAGS)
+        {
+            *out = static_cast<unsigned char>(value + WIDE_TAGS);
+            return out + 1;
+        }
+
+        // all eight bytes little endian, the tag keeps the significant ones
+        int bytes = (71 - __builtin_clzll(value)) / 8;
+        out[0] = static_cast<unsigned char>(bytes);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        std::memcpy(out + 1, &value, 8); // one store, the bytes are already in order
+#else
+        for (int i = 0; i < 8; i++)
+        {
+            out[1 + i] = static_cast<unsigned char>(value >> 8 * i);
+        }
+#endif
+        return out + 1 + bytes;
+    }
+
+    /**
+     * @param in : tag byte of the difference
+     * @param end : end of the bytes available
+     * @param value : set to the zigzagged difference, 0 for a STREAK_TAG
+     * @return : first byte after the difference, or after the tag of a streak
+     */
+    const unsigned char *getDifference(const unsigned char *in, const unsigned char *end, unsigned long long &value)
+    {
+        if (in == end)
+        {
+            throw std::runtime_error("Trace ends inside a call.");
+        }
+
+        unsigned char tag = *in++;
+        if (tag > WIDE_TAGS || tag == STREAK_TAG)
+        {
+            value = tag == STREAK_TAG ? 0 : tag - WIDE_TAGS;
+            return in;
+        }
+
+        if (end - in < tag)
+        {
+            throw std::runtime_error("Trace ends inside a call.");
+        }
+        value = 0;
+        for (int i = tag - 1; i >= 0; i--)
+        {
+            value = value << 8 | in[i];
+        }
+        return in + tag;
+    }
+
+    /**
+     * Moves past an access, a lone jump leaves the stride alone so a stream resumes after it for free
+     * @param address : address accessed
+     * @param last : previous address, set to this one
+     * @param step : previous difference, set to this one
+     * @param stride : set to the difference when it repeats the previous one
+     */
+    void follow(unsigned long long address, unsigned long long &last, unsigned long long &step,
+                unsigned long long &stride)
+    {
+        unsigned long long difference = address - last;
+        stride = difference == step ? difference : stride;
+        step = difference;
+        last = address;
+    }
+
+    /**
+     * @param in : first byte of the model
+     * @param end : end of the bytes available
+     * @param model : set to the decoded disk model
+     * @return : first byte after the model
+     */
+    const unsigned char *getDiskModel(const unsigned char *in, const unsigned char *end, DiskModel &model)
+    {
+        unsigned long long value;
+        in = getVarint(in, end, model.blocks);
+        in = getVarint(in, end, model.seekTime);
+        in = getVarint(in, end, model.accessTime);
+        in = getVarint(in, end, model.rotationTime);
+        in = getVarint(in, end, value);
+        model.queueDepth = static_cast<unsigned int>(value);
+        return in;
+    }
+
+    /**
+     * Decodes the options of a version 3 header, in the order encodeTraceHeader writes them
+     * @param in : first byte of the options
+     * @param end : end of the bytes available
+     * @param options : set to the decoded options, traceFile and compressTrace are left alone
+     * @return : first byte after the options
+     */
+    const unsigned char *getOptions(const unsigned char *in, const unsigned char *end, SimOSOptions &options)
+    {
+        unsigned long long value;
+        in = getVarint(in, end, value);
+        options.replacementPolicy = static_cast<ReplacementPolicyType>(value);
+        in = getVarint(in, end, value);
+        options.tlbSets = static_cast<unsigned int>(value);
+        in = getVarint(in, end, value);
+        options.tlbWays = static_cast<unsigned int>(value);
+        in = getVarint(in, end, value);
+        options.stackDistanceAnalysis = value != 0;
+        in = getVarint(in, end, value);
+        options.copyOnWriteFork = value != 0;
+        in = getVarint(in, end, value);
+        options.prefetchDepth = static_cast<unsigned int>(value);
+        in = getVarint(in, end, value);
+        options.prefetchPressureDepth = static_cast<unsigned int>(value);
+        in = getInt(in, end, options.cores);
+        in = getVarint(in, end, value);
+        options.scheduler = static_cast<SchedulerType>(value);
+        in = getVarint(in, end, value);
+        options.diskScheduler = static_cast<DiskSchedulerType>(value);
+        in = getDiskModel(in, end, options.diskModel);
+
+        unsigned long long disks;
+        in = getVarint(in, end, disks);
+        options.diskModels.clear();
+        for (unsigned long long i = 0; i < disks; i++)
+        {
+            options.diskModels.emplace_back();
+            in = getDiskModel(in, end, options.diskModels.back());
+        }
+
+        in = getVarint(in, end, options.fileCacheCapacity);
+        in = getVarint(in, end, value);
+        options.fileCachePolicy = static_cast<ReplacementPolicyType>(value);
+        in = getVarint(in, end, value);
+        options.coalesceDiskReads = value != 0;
+        in = getVarint(in, end, options.quantum);
+        in = getVarint(in, end, options.seed);
+        return in;
+    }
+
+    /**
+     * @param in : four bytes
+     * @return : the bytes as one value
+     */
+    unsigned int read32(const unsigned char *in)
+    {
+        unsigned int value;
+        std::memcpy(&value, in, sizeof(value));
+        return value;
+    }
+
+    /**
+     * Writes a length above 15 the LZ4 way, as 255s and a remainder
+     * @param length : length minus the 15 its token holds
+     * @param out : output
+     * @return : first byte after the length
+     */
+    unsigned char *putLength(std::size_t length, unsigned char *out)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            *out++ = 255;
+        }
+        *out++ = static_cast<unsigned char>(length);
+        return out;
+    }
+
+    /**
+     * Writes one sequence: literals, then a match unless it is the last sequence
+     * @param literals : first literal
+     * @param literalCount : number of literals
+     * @param offset : distance back to the match
+     * @param matchLength : bytes matched, 0 for the last sequence
+     * @param out : output
+     * @return : first byte after the sequence
+     */
+    unsigned char *putSequence(const unsigned char *literals, std::size_t literalCount, std::size_t offset,
+                               std::size_t matchLength, unsigned char *out)
+    {
+        std::size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH;
+        unsigned char *token = out++;
+        *token = static_cast<unsigned char>((literalCount < 15 ? literalCount : 15) << 4 |
+                                            (matchCode < 15 ? matchCode : 15));
+        if (literalCount >= 15)
+        {
+            out = putLength(literalCount - 15, out);
+        }
+        std::memcpy(out, literals, literalCount);
+        out += literalCount;
+
+        if (matchLength != 0)
+        {
+            *out++ = static_cast<unsigned char>(offset);
+            *out++ = static_cast<unsigned char>(offset >> 8);
+            if (matchCode >= 15)
+            {
+                out = putLength(matchCode - 15, out);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * LZ77 with a one-way hash of four byte sequences, in the LZ4 block layout. Trace calls repeat
+     * opcodes, cores and the differences of sequential accesses, which this catches cheaply; the
+     * search speeds up through stretches without matches, like random addresses.
+     * @param in : bytes to compress
+     * @param size : number of bytes
+     * @param out : room for compressBound(size) bytes
+     * @return : compressed size
+     */
+    std::size_t compressBlock(const unsigned char *in, std::size_t size, unsigned char *out)
+    {
+        unsigned int table[1 << HASH_BITS] = {0}; // position + 1 of the last sequence with each hash
+        unsigned char *start = out;
+        std::size_t anchor = 0;
+        std::size_t position = 0;
+        std::size_t limit = size > MIN_MATCH + LAST_LITERALS ? size - MIN_MATCH - LAST_LITERALS : 0;
+
+        while (position < limit)
+        {
+            unsigned int sequence = read32(in + position);
+            unsigned int hash = (sequence * 2654435761U) >> (32 - HASH_BITS);
+            std::size_t candidate = table[hash];
+            table[hash] = static_cast<unsigned int>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET || read32(in + candidate - 1) != sequence)
+            {
+                position += 1 + ((position - anchor) >> SKIP_STRENGTH); // incompressible stretches go by fast
+                continue;
+            }
+            candidate--;
+
+            std::size_t length = MIN_MATCH;
+            while (position + length < size - LAST_LITERALS && in[candidate + length] == in[position + length])
+            {
+                length++;
+            }
+
+            out = putSequence(in + anchor, position - anchor, position - candidate, length, out);
+            position += length;
+            anchor = position;
+        }
+
+        out = putSequence(in + anchor, size - anchor, 0, 0, out);
+        return out - start;
+    }
+
+    /**
+     * @param size : bytes to compress
+     * @return : most bytes compressBlock can write for them
+     */
+    std::size_t compressBound(std::size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    /**
+     * Reads a length continued past 15
+     * @param in : first byte of the continuation
+     * @param end : end of the compressed bytes
+     * @param length : 15, increased by the continuation
+     * @return : first byte after the length
+     */
+    const unsigned char *getLength(const unsigned char *in, const unsigned char *end, std::size_t &length)
+    {
+        unsigned char byte;
+        do
+        {
+            if (in == end)
+            {
+                throw std::runtime_error("Trace holds a damaged block.");
+            }
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+
+        return in;
+    }
+
+    /**
+     * Expands a block written by compressBlock, throws if it is damaged
+     * @param in : compressed bytes
+     * @param size : number of compressed bytes
+     * @param out : output
+     * @param outSize : size of the expanded block
+     */
+    void decompressBlock(const unsigned char *in, std::size_t size, unsigned char *out, std::size_t outSize)
+    {
+        const unsigned char *end = in + size;
+        std::size_t written = 0;
+
+        while (in < end)
+        {
+            unsigned char token = *in++;
+
+            std::size_t literals = token >> 4;
+            if (literals == 15)
+            {
+                in = getLength(in, end, literals);
+            }
+            if (literals > static_cast<std::size_t>(end - in) || literals > outSize - written)
+            {
+                throw std::runtime_error("Trace holds a damaged block.");
+            }
+            std::memcpy(out + written, in, literals);
+            in += literals;
+            written += literals;
+
+            if (in == end) // last sequence
+            {
+                break;
+            }
+
+            if (end - in < 2)
+            {
+                throw std::runtime_error("Trace holds a damaged block.");
+            }
+            std::size_t offset = in[0] | static_cast<std::size_t>(in[1]) << 8;
+            in += 2;
+
+            std::size_t length = token & 15;
+            if (length == 15)
+            {
+                in = getLength(in, end, length);
+            }
+            length += MIN_MATCH;
+            if (offset == 0 || offset > written || length > outSize - written)
+            {
+                throw std::runtime_error("Trace holds a damaged block.");
+            }
+
+            // byte by byte, a match may overlap what it copies
+            const unsigned char *from = out + written - offset;
+            for (std::size_t i = 0; i < length; i++)
+            {
+                out[written + i] = from[i];
+            }
+            written += length;
+        }
+
+        if (written != outSize)
+        {
+            throw std::runtime_error("Trace holds a damaged block.");
+        }
+    }
+}
+
+/**
+ * Encodes a call
+ * @param record : the call
+ * @param out : room for MAX_TRACE_RECORD_BYTES bytes
+ * @return : bytes written
+ */
+std::size_t encodeTraceRecord(const TraceRecord &record, unsigned char *out)
+{
+    unsigned char *start = out;
+    *out++ = static_cast<unsigned char>(record.op);
+
+    switch (record.op)
+    {
+    case TraceOp::FORK:
+    case TraceOp::EXIT:
+    case TraceOp::WAIT:
+    case TraceOp::TIMER:
+        out = putVarint(static_cast<unsigned int>(record.core), out);
+        break;
+    case TraceOp::DISK_READ:
+        out = putVarint(static_cast<unsigned int>(record.core), out);
+        out = putVarint(static_cast<unsigned int>(record.disk), out);
+        out = putVarint(record.file, out);
+        break;
+    case TraceOp::DISK_DONE:
+        out = putVarint(static_cast<unsigned int>(record.disk), out);
+        break;
+    case TraceOp::DISK_SLOT_DONE:
+        out = putVarint(static_cast<unsigned int>(record.disk), out);
+        out = putVarint(static_cast<unsigned int>(record.slot), out);
+        break;
+    case TraceOp::ACCESS:
+        out = putVarint(static_cast<unsigned int>(record.core), out);
+        out = putVarint(record.address, out);
+        *out++ = record.write ? 1 : 0;
+        break;
+    case TraceOp::SET_PRIORITY:
+        out = putVarint(static_cast<unsigned int>(record.pid), out);
+        out = putVarint(static_cast<unsigned int>(record.priority), out);
+        break;
+    case TraceOp::SET_DISK_SCHEDULER:
+        out = putVarint(static_cast<unsigned int>(record.disk), out);
+        out = putVarint(static_cast<unsigned int>(record.scheduler), out);
+        break;
+    case TraceOp::PLACE_FILE:
+        out = putVarint(static_cast<unsigned int>(record.disk), out);
+        out = putVarint(record.file, out);
+        out = putVarint(record.block, out);
+        break;
+    case TraceOp::FILE_NAME:
+        out = putVarint(record.nameLength, out);
+        std::memcpy(out, record.name, record.nameLength);
+        out += record.nameLength;
+        break;
+    case TraceOp::ACCESS_RUN:
+        out = putVarint(static_cast<unsigned int>(record.core), out);
+        *out++ = record.write ? 1 : 0;
+        *out++ = static_cast<unsigned char>(record.count); // last, so a writer can count up as it goes
+        break;
+    case TraceOp::NEW_PROCESS:
+    default:
+        break;
+    }
+
+    return out - start;
+}
+
+/**
+ * @param record : a call
+ * @return : most bytes its encoding can take
+ */
+std::size_t traceRecordBytes(const TraceRecord &record)
+{
+    return record.op == TraceOp::FILE_NAME ? 1 + MAX_VARINT_BYTES + record.nameLength : MAX_TRACE_RECORD_BYTES;
+}
+
+/**
+ * Decodes a call, throws if the bytes are not a whole call
+ * @param in : first byte of the call
+ * @param end : end of the bytes available
+ * @param record : set to the call
+ * @return : first byte after the call
+ */
+const unsigned char *decodeTraceRecord(const unsigned char *in, const unsigned char *end, TraceRecord &record)
+{
+    if (*in >= TRACE_OPS)
+    {
+        throw std::runtime_error("Trace holds an unknown call.");
+    }
+
+    record.op = static_cast<TraceOp>(*in++);
+
+    unsigned long long value;
+    switch (record.op)
+    {
+    case TraceOp::FORK:
+    case TraceOp::EXIT:
+    case TraceOp::WAIT:
+    case TraceOp::TIMER:
+        in = getInt(in, end, record.core);
+        break;
+    case TraceOp::DISK_READ:
+        in = getInt(in, end, record.core);
+        in = getInt(in, end, record.disk);
+        in = getVarint(in, end, value);
+        record.file = static_cast<unsigned int>(value);
+        break;
+    case TraceOp::DISK_DONE:
+        in = getInt(in, end, record.disk);
+        break;
+    case TraceOp::DISK_SLOT_DONE:
+        in = getInt(in, end, record.disk);
+        in = getInt(in, end, record.slot);
+        break;
+    case TraceOp::ACCESS:
+        in = getInt(in, end, record.core);
+        in = getVarint(in, end, record.address);
+        in = getVarint(in, end, value);
+        record.write = value != 0;
+        break;
+    case TraceOp::SET_PRIORITY:
+        in = getInt(in, end, record.pid);
+        in = getInt(in, end, record.priority);
+        break;
+    case TraceOp::SET_DISK_SCHEDULER:
+        in = getInt(in, end, record.disk);
+        in = getVarint(in, end, value);
+        record.scheduler = static_cast<DiskSchedulerType>(value);
+        break;
+    case TraceOp::PLACE_FILE:
+        in = getInt(in, end, record.disk);
+        in = getVarint(in, end, value);
+        record.file = static_cast<unsigned int>(value);
+        in = getVarint(in, end, record.block);
+        break;
+    case TraceOp::FILE_NAME:
+        in = getVarint(in, end, value);
+        if (static_cast<unsigned long long>(end - in) < value)
+        {
+            throw std::runtime_error("Trace ends inside a call.");
+        }
+        record.name = reinterpret_cast<const char *>(in);
+        record.nameLength = static_cast<std::size_t>(value);
+        in += value;
+        break;
+    case TraceOp::ACCESS_RUN:
+        in = getInt(in, end, record.core);
+        if (end - in < 2)
+        {
+            throw std::runtime_error("Trace ends inside a call.");
+        }
+        record.write = in[0] != 0;
+        record.count = in[1];
+        in += 2;
+        break;
+    case TraceOp::NEW_PROCESS:
+    default:
+        break;
+    }
+
+    return in;
+}
+
+/**
+ * @param header : trace settings and files
+ * @return : the header as it is stored at the start of a trace
+ */
+std::vector<unsigned char> encodeTraceHeader(const TraceHeader &header)
+{
+    std::vector<unsigned char> bytes(TRACE_MAGIC, TRACE_MAGIC + sizeof(TRACE_MAGIC));
+    unsigned char varint[10];
+
+    auto put = [&](unsigned long long value)
+    { bytes.insert(bytes.end(), varint, putVarint(value, varint)); };
+
+    put(header.version);
+    put(header.flags);
+    put(static_cast<unsigned int>(header.disks));
+    put(header.amountOfRAM);
+    put(header.pageSize);
+
+    const SimOSOptions &options = header.options;
+    auto putDisk = [&](const DiskModel &model)
+    {
+        put(model.blocks);
+        put(model.seekTime);
+        put(model.accessTime);
+        put(model.rotationTime);
+        put(model.queueDepth);
+    };
+    put(static_cast<unsigned int>(options.replacementPolicy));
+    put(options.tlbSets);
+    put(options.tlbWays);
+    put(options.stackDistanceAnalysis);
+    put(options.copyOnWriteFork);
+    put(options.prefetchDepth);
+    put(options.prefetchPressureDepth);
+    put(static_cast<unsigned int>(options.cores));
+    put(static_cast<unsigned int>(options.scheduler));
+    put(static_cast<unsigned int>(options.diskScheduler));
+    putDisk(options.diskModel);
+    put(options.diskModels.size());
+    for (const DiskModel &model : options.diskModels)
+    {
+        putDisk(model);
+    }
+    put(options.fileCacheCapacity);
+    put(static_cast<unsigned int>(options.fileCachePolicy));
+    put(options.coalesceDiskReads);
+    put(options.quantum);
+    put(options.seed);
+
+    put(header.files.size());
+    for (const std::string &name : header.files)
+    {
+        put(name.size());
+        bytes.insert(bytes.end(), name.begin(), name.end());
+    }
+
+    return bytes;
+}
+
+/**
+ * Decodes the header at the start of a trace, throws if it is not one this version reads
+ * @param in : first byte of the trace
+ * @param end : end of the trace
+ * @param header : set to the header
+ * @return : first byte after the header
+ */
+const unsigned char *decodeTraceHeader(const unsigned char *in, const unsigned char *end, TraceHeader &header)
+{
+    if (static_cast<std::size_t>(end - in) < sizeof(TRACE_MAGIC) ||
+        std::memcmp(in, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0)
+    {
+        throw std::runtime_error("Not a SimOS trace.");
+    }
+    in += sizeof(TRACE_MAGIC);
+
+    unsigned long long value;
+    in = getVarint(in, end, value);
+    if (value == 0 || value > TRACE_VERSION)
+    {
+        throw std::runtime_error("Unsupported trace version.");
+    }
+    header.version = static_cast<unsigned int>(value);
+
+    header.flags = 0; // version 1 had no flags
+    if (header.version >= 2)
+    {
+        in = getVarint(in, end, value);
+        header.flags = static_cast<unsigned int>(value);
+    }
+
+    in = getInt(in, end, header.disks);
+    in = getVarint(in, end, header.amountOfRAM);
+    in = getVarint(in, end, value);
+    header.pageSize = static_cast<unsigned int>(value);
+
+    SimOSOptions &options = header.options;
+    options = SimOSOptions(); // versions 1 and 2 only had cores
+    if (header.version < 3)
+    {
+        in = getInt(in, end, options.cores);
+    }
+    else
+    {
+        in = getOptions(in, end, options);
+    }
+
+    unsigned long long files;
+    in = getVarint(in, end, files);
+    header.files.clear();
+    for (unsigned long long i = 0; i < files; i++)
+    {
+        unsigned long long length;
+        in = getVarint(in, end, length);
+        if (static_cast<unsigned long long>(end - in) < length)
+        {
+            throw std::runtime_error("Trace ends inside its file table.");
+        }
+
+        header.files.emplace_back(reinterpret_cast<const char *>(in), length);
+        in += length;
+    }
+
+    return in;
+}
+
+/**
+ * Creates the file and writes the header, throws if the file cannot be created
+ * @param path : trace file
+ * @param header : settings and files of the trace, TRACE_COMPRESSED in its flags compresses it
+ */
+TraceWriter::TraceWriter(const std::string &path, const TraceHeader &header)
+    : file_(std::fopen(path.c_str(), "wb")), compress_((header.flags & TRACE_COMPRESSED) != 0),
+      buffer_(TRACE_BLOCK_BYTES), used_(0), run_(NO_RUN), runCore_(0), runWrite_(false), lastAddress_(0),
+      lastStep_(0), stride_(0), streak_(0), rawLeft_(0), rawStretch_(0)
+{
+    if (file_ == nullptr)
+    {
+        throw std::runtime_error("Cannot create trace file " + path + ".");
+    }
+
+    for (std::size_t i = 0; i < header.files.size(); i++)
+    {
+        files_.emplace(header.files[i], static_cast<unsigned int>(i));
+    }
+
+    std::vector<unsigned char> bytes = encodeTraceHeader(header);
+    std::fwrite(bytes.data(), 1, bytes.size(), file_);
+}
+
+TraceWriter::~TraceWriter()
+{
+    close();
+}
+
+/**
+ * Writes the buffered calls to the file
+ */
+void TraceWriter::flush()
+{
+    closeRun(); // runs never straddle blocks
+    if (used_ == 0)
+    {
+        return;
+    }
+    if (!compress_)
+    {
+        std::fwrite(buffer_.data(), 1, used_, file_);
+        used_ = 0;
+        return;
+    }
+
+    // compressing costs the most where it saves the least, so blocks that do not pay stop it for a while,
+    // a longer while each time in a row
+    std::size_t stored = 0;
+    if (rawLeft_ != 0)
+    {
+        rawLeft_--;
+    }
+    else
+    {
+        if (scratch_.size() < compressBound(used_))
+        {
+            scratch_.resize(compressBound(used_));
+        }
+        stored = compressBlock(buffer_.data(), used_, scratch_.data());
+        if (stored > used_ - (used_ >> MIN_SAVING_SHIFT))
+        {
+            rawStretch_ = std::min(rawStretch_ * 2 + 1, MAX_RAW_STRETCH);
+            rawLeft_ = rawStretch_;
+        }
+        else
+        {
+            rawStretch_ = 0;
+        }
+        stored = stored < used_ ? stored : 0;
+    }
+
+    // a stored size of 0 marks a block kept raw
+    unsigned char sizes[2 * MAX_VARINT_BYTES];
+    unsigned char *end = putVarint(used_, sizes);
+    end = putVarint(stored, end);
+    std::fwrite(sizes, 1, end - sizes, file_);
+    std::fwrite(stored != 0 ? scratch_.data() : buffer_.data(), 1, stored != 0 ? stored : used_, file_);
+    used_ = 0;
+}
+
+/**
+ * Ends the open run, if any, with its pending streak
+ */
+void TraceWriter::closeRun()
+{
+    if (streak_ != 0)
+    {
+        buffer_[used_++] = STREAK_TAG;
+        buffer_[used_++] = static_cast<unsigned char>(streak_ - 1);
+        streak_ = 0;
+    }
+    run_ = NO_RUN;
+}
+
+/**
+ * Makes room for bytes more, writing the buffered calls if they do not fit
+ * @param bytes : bytes about to be encoded
+ */
+void TraceWriter::reserve(std::size_t bytes)
+{
+    if (buffer_.size() - used_ < bytes)
+    {
+        flush();
+        if (buffer_.size() < bytes) // a name longer than a block
+        {
+            buffer_.resize(bytes);
+        }
+    }
+}
+
+/**
+ * Appends a call
+ * @param record : the call, not ACCESS_RUN or FILE_NAME
+ */
+void TraceWriter::write(const TraceRecord &record)
+{
+    if (record.op == TraceOp::ACCESS)
+    {
+        writeAccesses(record.core, record.write, &record.address, 1);
+        return;
+    }
+    if (file_ == nullptr)
+    {
+        return;
+    }
+
+    closeRun();
+    reserve(traceRecordBytes(record));
+    used_ += encodeTraceRecord(record, buffer_.data() + used_);
+}
+
+/**
+ * Appends accesses by one core, as if each was written as an ACCESS call
+ * @param core : core making the accesses
+ * @param write : true for writes
+ * @param addresses : logical addresses, in order
+ * @param count : number of addresses
+ */
+void TraceWriter::writeAccesses(int core, bool write, const unsigned long long *addresses, std::size_t count)
+{
+    if (file_ == nullptr)
+    {
+        return;
+    }
+
+    while (count > 0)
+    {
+        // a new run when this one is closed or full, or the next difference might not fit beside the streak
+        if (run_ == NO_RUN || core != runCore_ || write != runWrite_ || buffer_[run_] == MAX_TRACE_RUN ||
+            buffer_.size() - used_ < MAX_STREAK_BYTES + MAX_DIFFERENCE_BYTES)
+        {
+            closeRun();
+            TraceRecord run;
+            run.op = TraceOp::ACCESS_RUN;
+            run.core = core;
+            run.write = write;
+            reserve(MAX_TRACE_RECORD_BYTES + MAX_STREAK_BYTES + MAX_DIFFERENCE_BYTES);
+            used_ += encodeTraceRecord(run, buffer_.data() + used_);
+            run_ = used_ - 1; // the count is the last byte
+            runCore_ = core;
+            runWrite_ = write;
+        }
+
+        // as many as the run and the buffer surely have room for, kept in locals the stores cannot alias
+        std::size_t fit = std::min<std::size_t>({count, MAX_TRACE_RUN - buffer_[run_],
+                                                 (buffer_.size() - used_ - MAX_STREAK_BYTES) / MAX_DIFFERENCE_BYTES});
+        unsigned char *start = buffer_.data() + used_;
+        unsigned char *out = start;
+        unsigned long long last = lastAddress_;
+        unsigned long long step = lastStep_;
+        unsigned long long stride = stride_;
+        unsigned int streak = streak_;
+        for (std::size_t i = 0; i < fit; i++)
+        {
+            unsigned long long predicted = last + stride;
+            if (addresses[i] == predicted)
+            {
+                streak++;
+            }
+            else
+            {
+                if (streak != 0)
+                {
+                    *out++ = STREAK_TAG;
+                    *out++ = static_cast<unsigned char>(streak - 1);
+                    streak = 0;
+                }
+                out = putDifference(zigzag(predicted, addresses[i]), out);
+            }
+            follow(addresses[i], last, step, stride);
+        }
+
+        lastAddress_ = last;
+        lastStep_ = step;
+        stride_ = stride;
+        streak_ = streak;
+        used_ += out - start;
+        buffer_[run_] += static_cast<unsigned char>(fit);
+        addresses += fit;
+        count -= fit;
+    }
+}
+
+/**
+ * @param name : file name
+ * @return : index of the name in the file table, added with a FILE_NAME record the first time it is seen
+ */
+unsigned int TraceWriter::file(const std::string &name)
+{
+    auto found = files_.find(name);
+    if (found != files_.end())
+    {
+        return found->second;
+    }
+
+    unsigned int index = static_cast<unsigned int>(files_.size());
+    files_.emplace(name, index);
+
+    TraceRecord record;
+    record.op = TraceOp::FILE_NAME;
+    record.name = name.data();
+    record.nameLength = name.size();
+    write(record);
+
+    return index;
+}
+
+/**
+ * Writes what is buffered and closes the file, later writes are dropped
+ */
+void TraceWriter::close()
+{
+    if (file_ != nullptr)
+    {
+        flush();
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+/**
+ * Maps the file and reads its header, throws if it cannot be opened or is not a trace
+ * @param path : trace file
+ */
+TraceReader::TraceReader(const std::string &path)
+    : data_(nullptr), size_(0), ops_(nullptr), nextBlock_(nullptr), cursor_(nullptr), end_(nullptr), headerFiles_(0),
+      runLeft_(0), runCore_(0), runWrite_(false), lastAddress_(0), lastStep_(0), stride_(0),
+      streak_(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open trace file " + path + ".");
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || status.st_size == 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Not a SimOS trace.");
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+    void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map trace file " + path + ".");
+    }
+    data_ = static_cast<const unsigned char *>(mapped);
+    ::madvise(mapped, size_, MADV_SEQUENTIAL);
+
+    try
+    {
+        ops_ = decodeTraceHeader(data_, data_ + size_, header_);
+    }
+    catch (...)
+    {
+        ::munmap(mapped, size_);
+        throw;
+    }
+    headerFiles_ = header_.files.size();
+    rewind();
+}
+
+TraceReader::~TraceReader()
+{
+    ::munmap(const_cast<unsigned char *>(data_), size_);
+}
+
+/**
+ * Moves to the next block of a compressed trace, throws if it is damaged
+ * @return : false at the end of the trace
+ */
+bool TraceReader::loadBlock()
+{
+    const unsigned char *end = data_ + size_;
+    if (nextBlock_ == end)
+    {
+        return false;
+    }
+
+    unsigned long long rawSize;
+    unsigned long long stored;
+    const unsigned char *in = getVarint(nextBlock_, end, rawSize);
+    in = getVarint(in, end, stored);
+    if (static_cast<unsigned long long>(end - in) < (stored == 0 ? rawSize : stored))
+    {
+        throw std::runtime_error("Trace ends inside a block.");
+    }
+
+    if (stored == 0) // kept raw, read in place
+    {
+        cursor_ = in;
+        nextBlock_ = in + rawSize;
+    }
+    else
+    {
+        if (block_.size() < rawSize)
+        {
+            block_.resize(rawSize);
+        }
+        decompressBlock(in, stored, block_.data(), rawSize);
+        cursor_ = block_.data();
+        nextBlock_ = in + stored;
+    }
+    end_ = cursor_ + rawSize;
+
+    return true;
+}
+
+/**
+ * @return : settings of the trace, and its files so far
+ */
+const TraceHeader &TraceReader::header() const
+{
+    return header_;
+}
+
+/**
+ * Reads the next call, FILE_NAME records are added to the file table and skipped, runs are read one
+ * ACCESS at a time. Throws if the trace ends inside one
+ * @param record : set to the call
+ * @return : false at the end of the trace
+ */
+bool TraceReader::next(TraceRecord &record)
+{
+    while (true)
+    {
+        if (runLeft_ != 0)
+        {
+            record.address = lastAddress_ + stride_;
+            if (streak_ != 0)
+            {
+                streak_--;
+            }
+            else
+            {
+                unsigned long long difference;
+                cursor_ = getDifference(cursor_, end_, difference);
+                if (difference == 0) // a streak at predicted addresses, this access first
+                {
+                    if (cursor_ == end_)
+                    {
+                        throw std::runtime_error("Trace ends inside a call.");
+                    }
+                    streak_ = *cursor_++;
+                    if (streak_ >= runLeft_)
+                    {
+                        throw std::runtime_error("Trace holds a streak longer than its run.");
+                    }
+                }
+                else
+                {
+                    record.address = unzigzag(record.address, difference);
+                }
+            }
+            follow(record.address, lastAddress_, lastStep_, stride_);
+            runLeft_--;
+
+            record.op = TraceOp::ACCESS;
+            record.core = runCore_;
+            record.write = runWrite_;
+            return true;
+        }
+
+        while (cursor_ == end_)
+        {
+            if (!loadBlock())
+            {
+                return false;
+            }
+        }
+
+        cursor_ = decodeTraceRecord(cursor_, end_, record);
+        if (record.op == TraceOp::FILE_NAME)
+        {
+            header_.files.emplace_back(record.name, record.nameLength);
+        }
+        else if (record.op == TraceOp::ACCESS_RUN)
+        {
+            runLeft_ = record.count;
+            runCore_ = record.core;
+            runWrite_ = record.write;
+        }
+        else
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * Goes back to the first call
+ */
+void TraceReader::rewind()
+{
+    header_.files.resize(headerFiles_);
+    runLeft_ = 0;
+    lastAddress_ = 0;
+    lastStep_ = 0;
+    stride_ = 0;
+    streak_ = 0;
+
+    if (header_.flags & TRACE_COMPRESSED)
+    {
+        nextBlock_ = ops_;
+        cursor_ = nullptr;
+        end_ = nullptr;
+    }
+    else // one block holding every call
+    {
+        nextBlock_ = data_ + size_;
+        cursor_ = ops_;
+        end_ = data_ + size_;
+    }
+}
+
+/**
+ * @return : bytes of the trace file
+ */
+std::size_t TraceReader::fileBytes() const
+{
+    return size_;
+}
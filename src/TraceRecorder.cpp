@@ -0,0 +1,321 @@
+// Raed Abuzaid
+
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr unsigned char COPIED_ACCESSES{0}; // marks an AccessRun in a buffer
+    constexpr unsigned char COPIED_CALL{1};     // marks a CopiedCall in a buffer
+
+    /**
+     * Accesses copied into a buffer, the addresses follow it
+     */
+    struct AccessRun
+    {
+        unsigned char marker;
+        bool write;
+        int core;
+        unsigned int count;
+    };
+
+    /**
+     * Any other call copied into a buffer, the name of the file it reads or places follows it
+     */
+    struct CopiedCall
+    {
+        unsigned char marker;
+        TraceRecord record;
+        std::size_t nameLength;
+    };
+
+    /**
+     * @param bytes : bytes of something copied into a buffer
+     * @return : bytes it takes there, whole addresses so the ones after it stay aligned
+     */
+    constexpr std::size_t aligned(std::size_t bytes)
+    {
+        return (bytes + sizeof(unsigned long long) - 1) / sizeof(unsigned long long) * sizeof(unsigned long long);
+    }
+
+    constexpr std::size_t ACCESS_RUN_BYTES{aligned(sizeof(AccessRun))}; // before the addresses
+    constexpr std::size_t CALL_BYTES{aligned(sizeof(CopiedCall))};      // before the name
+}
+
+/**
+ * Creates the trace file and starts the flusher, throws if the file cannot be created
+ * @param path : trace file
+ * @param header : settings of the traced SimOS, TRACE_COMPRESSED in its flags compresses the calls
+ */
+TraceRecorder::TraceRecorder(const std::string &path, const TraceHeader &header)
+    : writer_(path, header), active_(0), used_(0), full_(false), fullBytes_(0), stopping_(false)
+{
+    buffers_[0].resize(TRACE_BLOCK_BYTES);
+    buffers_[1].resize(TRACE_BLOCK_BYTES);
+    flusher_ = std::thread(&TraceRecorder::flushLoop, this);
+}
+
+/**
+ * Writes every call recorded and closes the file
+ */
+TraceRecorder::~TraceRecorder()
+{
+    if (used_ != 0)
+    {
+        swapBuffers();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    flusher_.join();
+
+    writer_.close();
+}
+
+/**
+ * Hands the active buffer to the flusher and switches to the other one
+ */
+void TraceRecorder::swapBuffers()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]
+                      { return !full_; });
+        full_ = true;
+        fullBytes_ = used_;
+        active_ ^= 1;
+    }
+    changed_.notify_all();
+    used_ = 0;
+}
+
+/**
+ * Background thread, writes full buffers until stopped
+ */
+void TraceRecorder::flushLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        changed_.wait(lock, [this]
+                      { return full_ || stopping_; });
+        if (!full_)
+        {
+            return; // stopping with nothing left to write
+        }
+
+        // the recorder only touches the active buffer while full_ is set
+        const std::vector<unsigned char> &buffer = buffers_[active_ ^ 1];
+        std::size_t bytes = fullBytes_;
+        lock.unlock();
+        writeBuffer(buffer.data(), bytes);
+        lock.lock();
+
+        full_ = false;
+        changed_.notify_all();
+    }
+}
+
+/**
+ * Writes the calls copied into a full buffer
+ * @param calls : the buffer
+ * @param size : bytes of it
+ */
+void TraceRecorder::writeBuffer(const unsigned char *calls, std::size_t size)
+{
+    const unsigned char *in = calls;
+    const unsigned char *end = calls + size;
+
+    while (in < end)
+    {
+        if (*in == COPIED_ACCESSES)
+        {
+            AccessRun run;
+            std::memcpy(&run, in, sizeof(run));
+            in += ACCESS_RUN_BYTES;
+            // every entry takes whole addresses, so these are aligned where they were copied
+            writer_.writeAccesses(run.core, run.write, reinterpret_cast<const unsigned long long *>(in), run.count);
+            in += run.count * sizeof(unsigned long long);
+            continue;
+        }
+
+        CopiedCall call;
+        std::memcpy(&call, in, sizeof(call));
+        in += CALL_BYTES;
+        if (call.record.op == TraceOp::DISK_READ || call.record.op == TraceOp::PLACE_FILE)
+        {
+            call.record.file = writer_.file(std::string(reinterpret_cast<const char *>(in), call.nameLength));
+        }
+        in += aligned(call.nameLength);
+        writer_.write(call.record);
+    }
+}
+
+/**
+ * Copies a call into the active buffer
+ * @param record : the call
+ * @param fileName : file the call names, or nullptr
+ */
+void TraceRecorder::record(const TraceRecord &record, const std::string *fileName)
+{
+    CopiedCall call;
+    call.marker = COPIED_CALL;
+    call.record = record;
+    call.nameLength = fileName == nullptr ? 0 : fileName->size();
+
+    std::size_t bytes = CALL_BYTES + aligned(call.nameLength);
+    if (buffers_[active_].size() - used_ < bytes)
+    {
+        swapBuffers();
+        if (buffers_[active_].size() < bytes) // a name longer than a block
+        {
+            buffers_[active_].resize(bytes);
+        }
+    }
+
+    unsigned char *out = buffers_[active_].data() + used_;
+    std::memcpy(out, &call, sizeof(call));
+    if (fileName != nullptr)
+    {
+        std::memcpy(out + CALL_BYTES, fileName->data(), call.nameLength);
+    }
+    used_ += bytes;
+}
+
+/**
+ * Records a call taking a core, or NewProcess
+ * @param op : NEW_PROCESS, FORK, EXIT, WAIT or TIMER
+ * @param core : core passed
+ */
+void TraceRecorder::recordCall(TraceOp op, int core)
+{
+    TraceRecord call;
+    call.op = op;
+    call.core = core;
+    record(call);
+}
+
+/**
+ * @param core : core running the reading process
+ * @param disk : disk number
+ * @param fileName : file name
+ */
+void TraceRecorder::recordDiskRead(int core, int disk, const std::string &fileName)
+{
+    TraceRecord call;
+    call.op = TraceOp::DISK_READ;
+    call.core = core;
+    call.disk = disk;
+    record(call, &fileName);
+}
+
+/**
+ * @param disk : disk number
+ */
+void TraceRecorder::recordDiskDone(int disk)
+{
+    TraceRecord call;
+    call.op = TraceOp::DISK_DONE;
+    call.disk = disk;
+    record(call);
+}
+
+/**
+ * @param disk : disk number
+ * @param slot : slot
+ */
+void TraceRecorder::recordDiskDone(int disk, int slot)
+{
+    TraceRecord call;
+    call.op = TraceOp::DISK_SLOT_DONE;
+    call.disk = disk;
+    call.slot = slot;
+    record(call);
+}
+
+/**
+ * @param core : core running the process
+ * @param address : logical address
+ * @param write : true for a write
+ */
+void TraceRecorder::recordAccess(int core, unsigned long long address, bool write)
+{
+    recordAccesses(core, &address, 1, write);
+}
+
+/**
+ * @param core : core running the process
+ * @param addresses : logical addresses, in order
+ * @param count : number of addresses
+ * @param write : true for writes
+ */
+void TraceRecorder::recordAccesses(int core, const unsigned long long *addresses, std::size_t count, bool write)
+{
+    AccessRun run;
+    run.marker = COPIED_ACCESSES;
+    run.core = core;
+    run.write = write;
+
+    while (count > 0)
+    {
+        std::size_t room = buffers_[active_].size() - used_;
+        if (room < ACCESS_RUN_BYTES + sizeof(unsigned long long))
+        {
+            swapBuffers();
+            continue;
+        }
+
+        run.count = static_cast<unsigned int>(std::min(count, (room - ACCESS_RUN_BYTES) / sizeof(unsigned long long)));
+        unsigned char *out = buffers_[active_].data() + used_;
+        std::memcpy(out, &run, sizeof(run));
+        std::memcpy(out + ACCESS_RUN_BYTES, addresses, run.count * sizeof(unsigned long long));
+
+        used_ += ACCESS_RUN_BYTES + run.count * sizeof(unsigned long long);
+        addresses += run.count;
+        count -= run.count;
+    }
+}
+
+/**
+ * @param pid : process changed
+ * @param priority : new priority
+ */
+void TraceRecorder::recordPriority(int pid, int priority)
+{
+    TraceRecord call;
+    call.op = TraceOp::SET_PRIORITY;
+    call.pid = pid;
+    call.priority = priority;
+    record(call);
+}
+
+/**
+ * @param disk : disk number
+ * @param scheduler : new policy
+ */
+void TraceRecorder::recordDiskScheduler(int disk, DiskSchedulerType scheduler)
+{
+    TraceRecord call;
+    call.op = TraceOp::SET_DISK_SCHEDULER;
+    call.disk = disk;
+    call.scheduler = scheduler;
+    record(call);
+}
+
+/**
+ * @param disk : disk number
+ * @param fileName : file name
+ * @param block : block of the file
+ */
+void TraceRecorder::recordPlaceFile(int disk, const std::string &fileName, unsigned long long block)
+{
+    TraceRecord call;
+    call.op = TraceOp::PLACE_FILE;
+    call.disk = disk;
+    call.block = block;
+    record(call, &fileName);
+}
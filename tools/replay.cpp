@@ -0,0 +1,211 @@
+// Raed Abuzaid
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include "SimOS.h"
+#include "Trace.hpp"
+
+/**
+ * Replays a binary trace into a SimOS built with the settings and options in its header. Traces older than
+ * version 3 only hold the cores, the other options keep their defaults.
+ * RunUntil and ScheduleAction are not recorded, the events RunUntil handled are in the trace as the
+ * TimerInterrupt and DiskJobCompleted calls they made. So a replay reaches the same process, memory and disk
+ * state, but GetTime() stays 0 and the disk latency in GetDiskStats is not reproduced.
+ * Usage: replay <trace> [passes] [record]
+ * The trace is mapped and decoded in place, so no call allocates on the replay side. Runs of accesses by one
+ * core go through AccessMemoryAddresses. Calls SimOS rejects are counted and skipped. Given a record path the
+ * simulator records what it replays there, which measures the cost of recording.
+ */
+
+namespace
+{
+    constexpr std::size_t ACCESS_RUN{256};
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Accesses waiting to be made together, all by one core with one mode
+     */
+    struct AccessRun
+    {
+        unsigned long long addresses[ACCESS_RUN];
+        std::size_t count{0};
+        int core{0};
+        bool write{false};
+    };
+
+    /**
+     * Makes the waiting accesses
+     * @param os : simulator
+     * @param run : accesses, emptied
+     * @param rejected : incremented for every access SimOS rejects
+     */
+    void flushAccesses(SimOS &os, AccessRun &run, unsigned long long &rejected)
+    {
+        if (run.count == 0)
+        {
+            return;
+        }
+
+        try
+        {
+            os.AccessMemoryAddresses(run.addresses, run.count, run.write, run.core);
+        }
+        catch (const std::logic_error &)
+        {
+            rejected += run.count;
+        }
+        run.count = 0;
+    }
+
+    /**
+     * Makes one call other than an access
+     * @param os : simulator
+     * @param record : the call
+     * @param files : file table of the trace
+     */
+    void apply(SimOS &os, const TraceRecord &record, const std::vector<std::string> &files)
+    {
+        switch (record.op)
+        {
+        case TraceOp::NEW_PROCESS:
+            os.NewProcess();
+            break;
+        case TraceOp::FORK:
+            os.SimFork(record.core);
+            break;
+        case TraceOp::EXIT:
+            os.SimExit(record.core);
+            break;
+        case TraceOp::WAIT:
+            os.SimWait(record.core);
+            break;
+        case TraceOp::TIMER:
+            os.TimerInterrupt(record.core);
+            break;
+        case TraceOp::DISK_READ:
+            if (record.file >= files.size())
+            {
+                throw std::logic_error("Requested file out of range.");
+            }
+            os.DiskReadRequest(record.disk, files[record.file], record.core);
+            break;
+        case TraceOp::DISK_DONE:
+            os.DiskJobCompleted(record.disk);
+            break;
+        case TraceOp::DISK_SLOT_DONE:
+            os.DiskJobCompleted(record.disk, record.slot);
+            break;
+        case TraceOp::SET_PRIORITY:
+            os.SetPriority(record.pid, record.priority);
+            break;
+        case TraceOp::SET_DISK_SCHEDULER:
+            os.SetDiskScheduler(record.disk, record.scheduler);
+            break;
+        case TraceOp::PLACE_FILE:
+            if (record.file >= files.size())
+            {
+                throw std::logic_error("Requested file out of range.");
+            }
+            os.PlaceFile(record.disk, files[record.file], record.block);
+            break;
+        case TraceOp::ACCESS:
+        default:
+            os.AccessMemoryAddress(record.address, record.write, record.core);
+            break;
+        }
+    }
+
+    /**
+     * Replays every call of a trace once
+     * @param os : simulator
+     * @param reader : the trace, rewound first
+     * @param rejected : incremented for every call SimOS rejects
+     * @return : number of calls
+     */
+    unsigned long long replay(SimOS &os, TraceReader &reader, unsigned long long &rejected)
+    {
+        const std::vector<std::string> &files = reader.header().files;
+        AccessRun run;
+        TraceRecord record;
+        unsigned long long calls = 0;
+
+        reader.rewind();
+        while (reader.next(record))
+        {
+            calls++;
+
+            if (record.op == TraceOp::ACCESS)
+            {
+                if (run.count == ACCESS_RUN || (run.count != 0 && (run.core != record.core || run.write != record.write)))
+                {
+                    flushAccesses(os, run, rejected);
+                }
+                run.core = record.core;
+                run.write = record.write;
+                run.addresses[run.count++] = record.address;
+                continue;
+            }
+
+            flushAccesses(os, run, rejected);
+            try
+            {
+                apply(os, record, files);
+            }
+            catch (const std::logic_error &)
+            {
+                rejected++;
+            }
+        }
+        flushAccesses(os, run, rejected);
+
+        return calls;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <trace> [passes] [record]\n", argv[0]);
+        return 1;
+    }
+    int passes = argc > 2 ? std::atoi(argv[2]) : 1;
+
+    try
+    {
+        TraceReader reader(argv[1]);
+        const TraceHeader &header = reader.header();
+
+        SimOSOptions options = header.options;
+        options.traceFile = argc > 3 ? argv[3] : "";
+
+        unsigned long long calls = 0;
+        unsigned long long rejected = 0;
+        std::chrono::duration<double> elapsed(0);
+
+        // every pass starts from a fresh simulator, so passes only smooth out the timing
+        for (int pass = 0; pass < passes; pass++)
+        {
+            Clock::time_point start = Clock::now();
+            {
+                SimOS os(header.disks, header.amountOfRAM, header.pageSize, options);
+                calls += replay(os, reader, rejected);
+            } // a recording is complete once the simulator is gone
+            elapsed += Clock::now() - start;
+        }
+
+        std::printf("%llu calls (%zu bytes, %zu files), %llu rejected\n", calls, reader.fileBytes(),
+                    header.files.size(), rejected);
+        std::printf("%.3f s, %.0f calls/s\n", elapsed.count(), elapsed.count() > 0 ? calls / elapsed.count() : 0.0);
+    }
+    catch (const std::exception &error)
+    {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,547 @@
+// Raed Abuzaid
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "Trace.hpp"
+
+/**
+ * Converts a trace between the binary form and a text form, whichever the input is not.
+ * Usage: trace_convert [--raw] <input> <output>
+ * Text traces start with the header settings, one per line, then one call per line, for example
+ *
+ *     simos-trace 4
+ *     disks 2
+ *     ram 65536
+ *     page-size 4096
+ *     replacement-policy LRU
+ *     tlb 16 4
+ *     stack-distance 0
+ *     copy-on-write-fork 0
+ *     prefetch 0 1
+ *     cores 1
+ *     scheduler ROUND_ROBIN
+ *     disk-scheduler FCFS
+ *     disk-model 65536 1 4096 0 1
+ *     disk-model-of 1 131072 1 4096 0 2
+ *     file-cache 0 LRU
+ *     coalesce-disk-reads 0
+ *     quantum 0
+ *     seed 0
+ *     compressed 1
+ *     file "data.bin"
+ *     NewProcess
+ *     Access 0 0x1f40 w
+ *     DiskRead 0 1 "data.bin"
+ *     DiskDone 1
+ *     DiskSlotDone 1 0
+ *
+ * Options follow SimOSOptions: tlb is sets and ways, prefetch is the depth and the depth under pressure,
+ * a disk model is blocks, seek, access and rotation time and queue depth, disk-model-of gives one disk its
+ * own model and comes in disk order, file-cache is the capacity and policy. Settings left out keep their
+ * defaults. Arguments of calls come in the order SimOS takes them, except that cores, disks and pids come first.
+ * Names are quoted with \" and \\ escapes. Lines starting with # are comments.
+ * Binary output is compressed unless --raw is given or the text says compressed 0.
+ */
+
+namespace
+{
+    const char *const OP_NAMES[] = {"NewProcess", "Fork", "Exit", "Wait", "Timer", "DiskRead", "DiskDone",
+                                    "DiskSlotDone", "Access", "SetPriority", "SetDiskScheduler", "PlaceFile"};
+    constexpr int CALLS{sizeof(OP_NAMES) / sizeof(OP_NAMES[0])}; // FILE_NAME and ACCESS_RUN only exist in binary
+    const char *const POLICY_NAMES[] = {"LRU", "CLOCK", "SECOND_CHANCE", "LFU", "ARC", "TWO_Q"};
+    const char *const SCHEDULER_NAMES[] = {"ROUND_ROBIN", "PRIORITY", "MLFQ", "FAIR"};
+    const char *const DISK_SCHEDULER_NAMES[] = {"FCFS", "SSTF", "SCAN", "C_LOOK"};
+
+    /**
+     * @param name : file name
+     * @return : the name quoted for a text trace
+     */
+    std::string quote(const std::string &name)
+    {
+        std::string quoted("\"");
+        for (char c : name)
+        {
+            if (c == '"' || c == '\\')
+            {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    /**
+     * Reads a quoted name, throws if there is none
+     * @param line : the rest of a line
+     * @return : the name
+     */
+    std::string unquote(std::istringstream &line)
+    {
+        line >> std::ws;
+        if (line.get() != '"')
+        {
+            throw std::runtime_error("Expected a quoted file name.");
+        }
+
+        std::string name;
+        for (int c = line.get(); c != '"'; c = line.get())
+        {
+            if (c == '\\')
+            {
+                c = line.get();
+            }
+            if (c == EOF)
+            {
+                throw std::runtime_error("Unterminated file name.");
+            }
+            name += static_cast<char>(c);
+        }
+        return name;
+    }
+
+    /**
+     * Reads a number in decimal, or hex with 0x, negative numbers wrap like the ints they stand for. Throws if there is none
+     * @param line : the rest of a line
+     * @return : the number
+     */
+    unsigned long long number(std::istringstream &line)
+    {
+        std::string word;
+        if (!(line >> word))
+        {
+            throw std::runtime_error("Expected a number.");
+        }
+
+        char *end;
+        unsigned long long value = word[0] == '-' ? static_cast<unsigned long long>(std::strtoll(word.c_str(), &end, 0))
+                                                  : std::strtoull(word.c_str(), &end, 0);
+        if (*end != '\0')
+        {
+            throw std::runtime_error("Bad number " + word + ".");
+        }
+        return value;
+    }
+
+    /**
+     * Reads one of a list of names, throws if the word is none of them
+     * @param line : the rest of a line
+     * @param names : the names, in enum order
+     * @param kind : what the names are, for the error
+     * @return : index of the name
+     */
+    template <std::size_t N>
+    int choice(std::istringstream &line, const char *const (&names)[N], const std::string &kind)
+    {
+        std::string word;
+        line >> word;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            if (word == names[i])
+            {
+                return static_cast<int>(i);
+            }
+        }
+        throw std::runtime_error("Unknown " + kind + " " + word + ".");
+    }
+
+    /**
+     * @param names : the names, in enum order
+     * @param value : an enum value
+     * @return : its name, throws if it has none
+     */
+    template <std::size_t N>
+    const char *nameOf(const char *const (&names)[N], int value)
+    {
+        if (value < 0 || static_cast<std::size_t>(value) >= N)
+        {
+            throw std::runtime_error("Trace holds an unknown setting " + std::to_string(value) + ".");
+        }
+        return names[value];
+    }
+
+    /**
+     * @param out : text trace
+     * @param model : a disk model
+     */
+    void writeDiskModel(std::ostream &out, const DiskModel &model)
+    {
+        out << " " << model.blocks << " " << model.seekTime << " " << model.accessTime << " " << model.rotationTime
+            << " " << model.queueDepth << "\n";
+    }
+
+    /**
+     * @param line : the rest of a line
+     * @return : the disk model on it
+     */
+    DiskModel readDiskModel(std::istringstream &line)
+    {
+        DiskModel model;
+        model.blocks = number(line);
+        model.seekTime = number(line);
+        model.accessTime = number(line);
+        model.rotationTime = number(line);
+        model.queueDepth = static_cast<unsigned int>(number(line));
+        return model;
+    }
+
+    /**
+     * Reads a header setting
+     * @param word : first word of the line
+     * @param line : the rest of the line
+     * @param header : updated with the setting
+     * @return : false if the line is not a setting
+     */
+    bool readSetting(const std::string &word, std::istringstream &line, TraceHeader &header)
+    {
+        SimOSOptions &options = header.options;
+        if (word == "simos-trace")
+        {
+            number(line); // any version reads as the current one
+        }
+        else if (word == "disks")
+        {
+            header.disks = static_cast<int>(number(line));
+        }
+        else if (word == "ram")
+        {
+            header.amountOfRAM = number(line);
+        }
+        else if (word == "page-size")
+        {
+            header.pageSize = static_cast<unsigned int>(number(line));
+        }
+        else if (word == "replacement-policy")
+        {
+            options.replacementPolicy = static_cast<ReplacementPolicyType>(choice(line, POLICY_NAMES, "policy"));
+        }
+        else if (word == "tlb")
+        {
+            options.tlbSets = static_cast<unsigned int>(number(line));
+            options.tlbWays = static_cast<unsigned int>(number(line));
+        }
+        else if (word == "stack-distance")
+        {
+            options.stackDistanceAnalysis = number(line) != 0;
+        }
+        else if (word == "copy-on-write-fork")
+        {
+            options.copyOnWriteFork = number(line) != 0;
+        }
+        else if (word == "prefetch")
+        {
+            options.prefetchDepth = static_cast<unsigned int>(number(line));
+            options.prefetchPressureDepth = static_cast<unsigned int>(number(line));
+        }
+        else if (word == "cores")
+        {
+            options.cores = static_cast<int>(number(line));
+        }
+        else if (word == "scheduler")
+        {
+            options.scheduler = static_cast<SchedulerType>(choice(line, SCHEDULER_NAMES, "scheduler"));
+        }
+        else if (word == "disk-scheduler")
+        {
+            int scheduler = choice(line, DISK_SCHEDULER_NAMES, "disk scheduler");
+            options.diskScheduler = static_cast<DiskSchedulerType>(scheduler);
+        }
+        else if (word == "disk-model")
+        {
+            options.diskModel = readDiskModel(line);
+        }
+        else if (word == "disk-model-of")
+        {
+            if (number(line) != options.diskModels.size())
+            {
+                throw std::runtime_error("Disk models must come in disk order.");
+            }
+            options.diskModels.push_back(readDiskModel(line));
+        }
+        else if (word == "file-cache")
+        {
+            options.fileCacheCapacity = number(line);
+            options.fileCachePolicy = static_cast<ReplacementPolicyType>(choice(line, POLICY_NAMES, "policy"));
+        }
+        else if (word == "coalesce-disk-reads")
+        {
+            options.coalesceDiskReads = number(line) != 0;
+        }
+        else if (word == "quantum")
+        {
+            options.quantum = number(line);
+        }
+        else if (word == "seed")
+        {
+            options.seed = number(line);
+        }
+        else if (word == "compressed")
+        {
+            if (number(line) == 0)
+            {
+                header.flags &= ~TRACE_COMPRESSED;
+            }
+        }
+        else if (word == "file")
+        {
+            header.files.push_back(unquote(line));
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Writes a binary trace as text
+     * @param input : binary trace
+     * @param output : text trace
+     */
+    void toText(const std::string &input, const std::string &output)
+    {
+        TraceReader reader(input);
+        const TraceHeader &header = reader.header();
+        std::ofstream out(output);
+        if (!out)
+        {
+            throw std::runtime_error("Cannot create " + output + ".");
+        }
+
+        const SimOSOptions &options = header.options;
+        out << "simos-trace " << header.version << "\n"
+            << "disks " << header.disks << "\n"
+            << "ram " << header.amountOfRAM << "\n"
+            << "page-size " << header.pageSize << "\n"
+            << "replacement-policy " << nameOf(POLICY_NAMES, static_cast<int>(options.replacementPolicy)) << "\n"
+            << "tlb " << options.tlbSets << " " << options.tlbWays << "\n"
+            << "stack-distance " << options.stackDistanceAnalysis << "\n"
+            << "copy-on-write-fork " << options.copyOnWriteFork << "\n"
+            << "prefetch " << options.prefetchDepth << " " << options.prefetchPressureDepth << "\n"
+            << "cores " << options.cores << "\n"
+            << "scheduler " << nameOf(SCHEDULER_NAMES, static_cast<int>(options.scheduler)) << "\n"
+            << "disk-scheduler " << nameOf(DISK_SCHEDULER_NAMES, static_cast<int>(options.diskScheduler)) << "\n"
+            << "disk-model";
+        writeDiskModel(out, options.diskModel);
+        for (std::size_t disk = 0; disk < options.diskModels.size(); disk++)
+        {
+            out << "disk-model-of " << disk;
+            writeDiskModel(out, options.diskModels[disk]);
+        }
+        out << "file-cache " << options.fileCacheCapacity << " "
+            << nameOf(POLICY_NAMES, static_cast<int>(options.fileCachePolicy)) << "\n"
+            << "coalesce-disk-reads " << options.coalesceDiskReads << "\n"
+            << "quantum " << options.quantum << "\n"
+            << "seed " << options.seed << "\n"
+            << "compressed " << (header.flags & TRACE_COMPRESSED ? 1 : 0) << "\n";
+        for (const std::string &name : header.files)
+        {
+            out << "file " << quote(name) << "\n";
+        }
+
+        char address[32];
+        TraceRecord record;
+        while (reader.next(record))
+        {
+            out << OP_NAMES[static_cast<int>(record.op)];
+            switch (record.op)
+            {
+            case TraceOp::FORK:
+            case TraceOp::EXIT:
+            case TraceOp::WAIT:
+            case TraceOp::TIMER:
+                out << " " << record.core;
+                break;
+            case TraceOp::DISK_READ:
+                out << " " << record.core << " " << record.disk << " " << quote(header.files.at(record.file));
+                break;
+            case TraceOp::DISK_DONE:
+                out << " " << record.disk;
+                break;
+            case TraceOp::DISK_SLOT_DONE:
+                out << " " << record.disk << " " << record.slot;
+                break;
+            case TraceOp::ACCESS:
+                std::snprintf(address, sizeof(address), "%#llx", record.address);
+                out << " " << record.core << " " << address << (record.write ? " w" : " r");
+                break;
+            case TraceOp::SET_PRIORITY:
+                out << " " << record.pid << " " << record.priority;
+                break;
+            case TraceOp::SET_DISK_SCHEDULER:
+                out << " " << record.disk << " " << DISK_SCHEDULER_NAMES[static_cast<int>(record.scheduler) & 3];
+                break;
+            case TraceOp::PLACE_FILE:
+                out << " " << record.disk << " " << quote(header.files.at(record.file)) << " " << record.block;
+                break;
+            case TraceOp::NEW_PROCESS:
+            default:
+                break;
+            }
+            out << "\n";
+        }
+    }
+
+    /**
+     * Writes a text trace as binary
+     * @param input : text trace
+     * @param output : binary trace
+     * @param raw : leave the calls uncompressed
+     */
+    void toBinary(const std::string &input, const std::string &output, bool raw)
+    {
+        std::ifstream in(input);
+        if (!in)
+        {
+            throw std::runtime_error("Cannot open " + input + ".");
+        }
+
+        TraceHeader header;
+        header.flags = raw ? 0 : TRACE_COMPRESSED;
+        std::unique_ptr<TraceWriter> writer; // created at the first call, once the header is complete
+
+        std::string text;
+        for (int lineNumber = 1; std::getline(in, text); lineNumber++)
+        {
+            std::istringstream line(text);
+            std::string word;
+            if (!(line >> word) || word[0] == '#')
+            {
+                continue;
+            }
+
+            try
+            {
+                if (!writer)
+                {
+                    if (readSetting(word, line, header))
+                    {
+                        continue;
+                    }
+                    writer.reset(new TraceWriter(output, header));
+                }
+
+                int op = 0;
+                while (op < CALLS && word != OP_NAMES[op])
+                {
+                    op++;
+                }
+                if (op == CALLS)
+                {
+                    throw std::runtime_error("Unknown call " + word + ".");
+                }
+
+                TraceRecord record;
+                record.op = static_cast<TraceOp>(op);
+                switch (record.op)
+                {
+                case TraceOp::FORK:
+                case TraceOp::EXIT:
+                case TraceOp::WAIT:
+                case TraceOp::TIMER:
+                    record.core = static_cast<int>(number(line));
+                    break;
+                case TraceOp::DISK_READ:
+                    record.core = static_cast<int>(number(line));
+                    record.disk = static_cast<int>(number(line));
+                    record.file = writer->file(unquote(line));
+                    break;
+                case TraceOp::DISK_DONE:
+                    record.disk = static_cast<int>(number(line));
+                    break;
+                case TraceOp::DISK_SLOT_DONE:
+                    record.disk = static_cast<int>(number(line));
+                    record.slot = static_cast<int>(number(line));
+                    break;
+                case TraceOp::ACCESS:
+                    record.core = static_cast<int>(number(line));
+                    record.address = number(line);
+                    line >> word;
+                    record.write = word == "w";
+                    break;
+                case TraceOp::SET_PRIORITY:
+                    record.pid = static_cast<int>(number(line));
+                    record.priority = static_cast<int>(number(line));
+                    break;
+                case TraceOp::SET_DISK_SCHEDULER:
+                {
+                    record.disk = static_cast<int>(number(line));
+                    int scheduler = choice(line, DISK_SCHEDULER_NAMES, "disk scheduler");
+                    record.scheduler = static_cast<DiskSchedulerType>(scheduler);
+                    break;
+                }
+                case TraceOp::PLACE_FILE:
+                    record.disk = static_cast<int>(number(line));
+                    record.file = writer->file(unquote(line));
+                    record.block = number(line);
+                    break;
+                case TraceOp::NEW_PROCESS:
+                default:
+                    break;
+                }
+                writer->write(record);
+            }
+            catch (const std::runtime_error &error)
+            {
+                throw std::runtime_error(input + ":" + std::to_string(lineNumber) + ": " + error.what());
+            }
+        }
+
+        if (!writer) // a trace with no calls
+        {
+            writer.reset(new TraceWriter(output, header));
+        }
+    }
+
+    /**
+     * @param path : a file
+     * @return : true if it starts like a binary trace
+     */
+    bool isBinary(const std::string &path)
+    {
+        char magic[sizeof(TRACE_MAGIC)] = {0};
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("Cannot open " + path + ".");
+        }
+        in.read(magic, sizeof(magic));
+        return std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bool raw = argc > 1 && std::strcmp(argv[1], "--raw") == 0;
+    if (argc != (raw ? 4 : 3))
+    {
+        std::fprintf(stderr, "usage: %s [--raw] <input> <output>\n", argv[0]);
+        return 1;
+    }
+    std::string input = argv[raw ? 2 : 1];
+    std::string output = argv[raw ? 3 : 2];
+
+    try
+    {
+        if (isBinary(input))
+        {
+            toText(input, output);
+        }
+        else
+        {
+            toBinary(input, output, raw);
+        }
+    }
+    catch (const std::exception &error)
+    {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    return 0;
+}